@@ -0,0 +1,512 @@
+//==============================================================================================
+// File: LadderBenchmark.cpp - Word ladder benchmark suite implementation
+// c.f.: LadderBenchmark.h
+//
+// This class times the word ladder engine's lookups and searches on a
+// dictionary, and reports the results as a table and as JSON.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "LadderBenchmark.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <random>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "Psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+	// The number of heap allocations made so far, counted by the operator new below. The
+	// searches may run on other threads, so the count is atomic.
+	//
+	atomic<long long> allocationCount(0);
+
+
+	//------------------------------------------------------------------------------------------
+	// Writes a string as a JSON string literal. Dictionary labels are usually file paths, which
+	// on Windows are full of backslashes.
+	//
+	void writeJsonString(ostream& output, const string& str)
+	{
+		const char* hexDigits = "0123456789abcdef";
+
+		output << '"';
+
+		for (char c : str)
+		{
+			if (c == '"' || c == '\\')
+			{
+				output << '\\' << c;
+			}
+			else if ((unsigned char)c < 0x20)
+			{
+				output << "\\u00" << hexDigits[(c >> 4) & 0xF] << hexDigits[c & 0xF];
+			}
+			else
+			{
+				output << c;
+			}
+		}
+
+		output << '"';
+	}
+}
+
+// Replacing the global operator new lets us count every heap allocation the program makes,
+// whether it comes from a container, a string or a plain new. The array and nothrow forms go
+// through these by default. The deletes have to be replaced along with it, so that memory from
+// our malloc is given back to free.
+//
+void* operator new(size_t size)
+{
+	allocationCount++;
+
+	void* memory = malloc(size == 0 ? 1 : size);
+
+	if (memory == nullptr)
+	{
+		throw bad_alloc();
+	}
+
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+LadderBenchmark::LadderBenchmark(double minimumSeconds)
+{
+	this->minimumSeconds = minimumSeconds;
+	dictionaryStart = 0;
+	checksum = 0;
+}
+
+template <typename Operation>
+LadderBenchmark::Result& LadderBenchmark::measure(const string& name, const Result& context, int roundSize, Operation operation)
+{
+	// We only look at the clock between rounds, so that reading
+	// it doesn't get counted against the cheap operations.
+	//
+	Result result = context;
+
+	result.name = name;
+	result.operations = 0;
+	result.expandedWords = 0;
+
+	long long startAllocations = getAllocationCount();
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	do
+	{
+		for (int i = 0; i < roundSize; i++)
+		{
+			operation(i);
+		}
+
+		result.operations += roundSize;
+		result.seconds = getSecondsSince(start);
+	} while (result.seconds < minimumSeconds);
+
+	result.allocations = getAllocationCount() - startAllocations;
+	result.peakMemory = getPeakMemory();
+	results.push_back(result);
+
+	return results.back();
+}
+
+void LadderBenchmark::runDictionary(const string& label, const string& fileName, int wordLength)
+{
+	// We time the load first, while nothing else is in memory.
+	// Each load replaces the last, and the last one is kept for
+	// every other benchmark, so a big dictionary that only loads
+	// once isn't loaded all over again.
+	//
+	dictionaryStart = results.size();
+
+	Result context;
+
+	context.dictionary = label;
+	context.wordCount = 0;
+	context.wordLength = wordLength;
+
+	WordLadder* wordLadder = nullptr;
+
+	measure("load", context, 1, [&](int)
+	{
+		delete wordLadder;
+
+		wordLadder = new WordLadder(fileName, wordLength);
+		checksum += wordLadder->getWordCount();
+	});
+
+	context.wordCount = wordLadder->getWordCount();
+	results.back().wordCount = context.wordCount; // The load didn't know the count until it had loaded.
+
+	if (context.wordCount > 0) // There's nothing to look up in an empty lexicon.
+	{
+		runLookupsAndSearches(context, *wordLadder);
+	}
+
+	delete wordLadder;
+}
+
+void LadderBenchmark::runLookupsAndSearches(const Result& context, WordLadder& wordLadder)
+{
+	// Every lookup and query set is picked before any timing
+	// starts, so that picking them isn't timed.
+	//
+	int wordCount = context.wordCount;
+	int wordLength = context.wordLength;
+
+	// The lookups are half words, half non-words, made by changing
+	// letters of a word until it isn't one. Both go through the
+	// same binary search, but a miss always runs it to the end,
+	// while a hit can stop early.
+	mt19937 random(QUERY_SEED);
+	vector<string> lookups;
+
+	for (int i = 0; i < LOOKUP_COUNT; i++)
+	{
+		string word = wordLadder.getWord(random() % wordCount);
+
+		if (i % 2 == 1)
+		{
+			for (int attempt = 0; attempt < 26 && wordLadder.isWord(word); attempt++)
+			{
+				word[random() % wordLength] = 'A' + random() % 26;
+			}
+		}
+
+		lookups.push_back(word);
+	}
+
+	measure("isWord", context, LOOKUP_COUNT, [&](int i)
+	{
+		checksum += wordLadder.isWord(lookups[i]);
+	});
+
+	measure("getNeighbors", context, LOOKUP_COUNT / 2, [&](int i)
+	{
+		checksum += wordLadder.getNeighbors(lookups[2 * i]).size();
+	});
+
+	measure("getHammingDistance", context, LOOKUP_COUNT - 1, [&](int i)
+	{
+		checksum += wordLadder.getHammingDistance(lookups[i], lookups[i + 1]);
+	});
+
+	vector<pair<string, string>> shortQueries;
+	vector<pair<string, string>> longQueries;
+	vector<pair<string, string>> unreachableQueries;
+
+	pickQueries(wordLadder, shortQueries, longQueries, unreachableQueries);
+
+	measureSearches("getMinLadder (short)", context, wordLadder, shortQueries);
+	measureSearches("getMinLadder (long)", context, wordLadder, longQueries);
+	measureSearches("getMinLadder (unreachable)", context, wordLadder, unreachableQueries);
+	measureIdSearches("getMinLadder by ID (short)", context, wordLadder, shortQueries);
+	measureIdSearches("getMinLadder by ID (long)", context, wordLadder, longQueries);
+
+	// The updates come last, as putting a word back can list the
+	// neighbors in a different order, which could change which of
+	// several minimum ladders the searches above return.
+	measure("removeWord + addWord", context, UPDATE_COUNT, [&](int i)
+	{
+		const string& word = lookups[2 * i]; // The even lookups are all words.
+
+		checksum += wordLadder.removeWord(word) + wordLadder.addWord(word);
+	});
+}
+
+const vector<LadderBenchmark::Result>& LadderBenchmark::getResults() const
+{
+	return results;
+}
+
+const vector<string>& LadderBenchmark::getAllocationFailures() const
+{
+	return allocationFailures;
+}
+
+void LadderBenchmark::writeJson(ostream& output) const
+{
+	output << "{\n  \"peakMemory\": " << getPeakMemory() << ",\n  \"checksum\": " << checksum << ",\n  \"results\": [";
+
+	for (unsigned int i = 0; i < results.size(); i++)
+	{
+		const Result& result = results[i];
+
+		output << (i == 0 ? "\n" : ",\n") << "    {\"dictionary\": ";
+		writeJsonString(output, result.dictionary);
+		output << ", \"wordCount\": " << result.wordCount << ", \"wordLength\": " << result.wordLength << ", \"name\": ";
+		writeJsonString(output, result.name);
+		output << ", \"operations\": " << result.operations << ", \"seconds\": " << result.seconds;
+		output << ", \"nanosecondsPerOperation\": " << result.seconds * 1e9 / result.operations;
+		output << ", \"allocationsPerOperation\": " << (double)result.allocations / result.operations;
+
+		if (result.expandedWords > 0)
+		{
+			output << ", \"expandedWords\": " << result.expandedWords << ", \"expandedWordsPerSecond\": " << result.expandedWords / result.seconds;
+		}
+
+		output << ", \"peakMemory\": " << result.peakMemory << "}";
+	}
+
+	output << "\n  ]\n}\n";
+}
+
+void LadderBenchmark::printDictionaryResults(ostream& output) const
+{
+	if (dictionaryStart >= results.size())
+	{
+		return;
+	}
+
+	output << results[dictionaryStart].dictionary << " (" << results[dictionaryStart].wordCount << " words of " << results[dictionaryStart].wordLength << " letters)\n";
+
+	for (size_t i = dictionaryStart; i < results.size(); i++)
+	{
+		const Result& result = results[i];
+
+		output << "  " << left << setw(28) << result.name << right << fixed << setprecision(1) << setw(16) << result.seconds * 1e9 / result.operations << " ns/op";
+		output << setw(10) << (double)result.allocations / result.operations << " allocs/op";
+
+		if (result.expandedWords > 0)
+		{
+			output << setw(14) << result.expandedWords / result.seconds / 1e6 << "M words/s";
+		}
+
+		output << "\n";
+	}
+
+	output << "  peak memory " << getPeakMemory() / (1 << 20) << " MiB\n" << defaultfloat << flush;
+}
+
+long long LadderBenchmark::getPeakMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.PeakWorkingSetSize;
+	}
+
+	return 0;
+#else
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+
+#ifdef __APPLE__
+	return usage.ru_maxrss;			// macOS reports bytes,
+#else
+	return usage.ru_maxrss * 1024LL;	// while Linux reports kilobytes.
+#endif
+#endif
+}
+
+int LadderBenchmark::getMostCommonLength(const string& fileName)
+{
+	ifstream file(fileName);
+	map<int, int> lengthCounts;
+	string word;
+
+	while (file >> word)
+	{
+		lengthCounts[word.length()]++;
+	}
+
+	int mostCommon = 0;
+
+	for (const pair<const int, int>& lengthCount : lengthCounts)
+	{
+		if (mostCommon == 0 || lengthCount.second > lengthCounts[mostCommon])
+		{
+			mostCommon = lengthCount.first;
+		}
+	}
+
+	return mostCommon;
+}
+
+void LadderBenchmark::pickQueries(const WordLadder& wordLadder, vector<pair<string, string>>& shortQueries,
+	vector<pair<string, string>>& longQueries, vector<pair<string, string>>& unreachableQueries)
+{
+	// The short and long queries both come from the search tree of
+	// a random start word: a short query ends at a random word 2
+	// or 3 steps away, and a long one at the alphabetically first
+	// of the words furthest away. Start words with no neighbors
+	// are passed over, since they have no ladders at all.
+	//
+	int wordCount = wordLadder.getWordCount();
+	mt19937 random(QUERY_SEED);
+	WordLadder::SearchWorkspace state;
+
+	for (int attempt = 0; attempt < QUERY_COUNT * 16 && (int)longQueries.size() < QUERY_COUNT; attempt++)
+	{
+		int start = random() % wordCount;
+
+		if (wordLadder.componentSizes[wordLadder.wordComponents[start]] == 1)
+		{
+			continue;
+		}
+
+		vector<int> tree = wordLadder.getSearchTree(wordLadder.getWord(start), state);
+		vector<int> depths(wordCount, -1);
+		vector<int> path;
+		vector<int> nearWords;
+		int farthest = start;
+
+		depths[start] = 0;
+
+		for (int id = 0; id < wordCount; id++)
+		{
+			// A word's depth is one more than its parent's, so we
+			// climb until we reach a word whose depth we know, then
+			// fill in the depths on the way back down.
+			for (int ancestor = id; tree[ancestor] != -1 && depths[ancestor] == -1; ancestor = tree[ancestor])
+			{
+				path.push_back(ancestor);
+			}
+
+			for (size_t i = path.size(); i-- > 0;)
+			{
+				depths[path[i]] = depths[tree[path[i]]] + 1;
+			}
+
+			path.clear();
+
+			if (depths[id] == 2 || depths[id] == 3)
+			{
+				nearWords.push_back(id);
+			}
+
+			if (depths[id] > depths[farthest])
+			{
+				farthest = id;
+			}
+		}
+
+		if (!nearWords.empty())
+		{
+			shortQueries.push_back(make_pair(wordLadder.getWord(start), wordLadder.getWord(nearWords[random() % nearWords.size()])));
+		}
+
+		longQueries.push_back(make_pair(wordLadder.getWord(start), wordLadder.getWord(farthest)));
+	}
+
+	// The unreachable queries are random pairs of words that are
+	// in different components. A lexicon with a single component
+	// has none.
+	for (int attempt = 0; attempt < QUERY_COUNT * 16 && (int)unreachableQueries.size() < QUERY_COUNT; attempt++)
+	{
+		int start = random() % wordCount;
+		int end = random() % wordCount;
+
+		if (wordLadder.wordComponents[start] != wordLadder.wordComponents[end])
+		{
+			unreachableQueries.push_back(make_pair(wordLadder.getWord(start), wordLadder.getWord(end)));
+		}
+	}
+}
+
+void LadderBenchmark::measureSearches(const string& name, const Result& context, const WordLadder& wordLadder,
+	const vector<pair<string, string>>& queries)
+{
+	if (queries.empty())
+	{
+		return;
+	}
+
+	WordLadder::SearchWorkspace state;
+	long long expandedWords = 0;
+
+	Result& result = measure(name, context, queries.size(), [&](int i)
+	{
+		checksum += wordLadder.getMinLadder(queries[i].first, queries[i].second, state).size();
+		expandedWords += state.expandedWords;
+	});
+
+	result.expandedWords = expandedWords;
+}
+
+void LadderBenchmark::measureIdSearches(const string& name, const Result& context, const WordLadder& wordLadder,
+	const vector<pair<string, string>>& queries)
+{
+	if (queries.empty())
+	{
+		return;
+	}
+
+	vector<pair<int, int>> idQueries;
+
+	for (const pair<string, string>& query : queries)
+	{
+		idQueries.push_back(make_pair(wordLadder.getWordId(query.first), wordLadder.getWordId(query.second)));
+	}
+
+	WordLadder::SearchWorkspace state;
+	vector<int> ladder;
+	string text;
+	long long expandedWords = 0;
+
+	for (const pair<int, int>& query : idQueries)
+	{
+		wordLadder.getMinLadder(query.first, query.second, state, ladder);
+		wordLadder.formatResult(ladder, text);
+	}
+
+	Result& result = measure(name, context, idQueries.size(), [&](int i)
+	{
+		wordLadder.getMinLadder(idQueries[i].first, idQueries[i].second, state, ladder);
+		wordLadder.formatResult(ladder, text);
+
+		checksum += ladder.size() + text.size();
+		expandedWords += state.expandedWords;
+	});
+
+	result.expandedWords = expandedWords;
+
+	// Everything the queries need has grown to fit during the
+	// warm-up pass, so a single allocation now is a regression.
+	if (result.allocations != 0)
+	{
+		allocationFailures.push_back(result.dictionary + ": " + name);
+	}
+}
+
+long long LadderBenchmark::getAllocationCount()
+{
+	return allocationCount;
+}
+
+double LadderBenchmark::getSecondsSince(chrono::steady_clock::time_point start)
+{
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	return elapsed.count();
+}
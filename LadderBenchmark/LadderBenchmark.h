@@ -0,0 +1,184 @@
+#pragma once
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "WordLadder.h"
+
+//
+// LadderBenchmark.h Defines the benchmark suite for the word ladder engine. For each dictionary it is
+// given, it times:
+//
+//     load                 constructing a WordLadder from the dictionary file, index included
+//     isWord               looking up words, half of them in the lexicon and half not
+//     getNeighbors         finding every neighbor of a word
+//     getHammingDistance   comparing two words
+//     getMinLadder         answering three fixed query sets: short ladders (2 or 3 steps), the
+//                          longest ladder from each start word, and pairs with no ladder at all
+//     getMinLadder by ID   answering the short and long sets with the ID-based query, formatting
+//                          each ladder into a reused string, after one untimed pass to warm up
+//     removeWord + addWord taking a word out of the lexicon and putting it back, which patches the
+//                          index twice; the lexicon ends up as it started
+//
+// Every result gives nanoseconds per operation, and heap allocations per operation, which the
+// benchmark counts by replacing the global operator new. The ID-based queries must make none at
+// all once warmed up; any that do are reported by getAllocationFailures, and the benchmark program
+// exits with status 1, so the check can gate a build. The searches also give the number of words
+// they expanded per second. The query sets are picked with a fixed seed, so a dictionary gets the
+// same queries every run, and the results of two versions of the engine can be compared line by
+// line.
+//
+// The results, along with the peak resident memory of the process, are written out as JSON.
+//
+
+using namespace std;
+
+class LadderBenchmark
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // The timing of one benchmark on one dictionary.
+    //
+    struct Result
+    {
+        string dictionary;              // The label of the dictionary
+        int wordCount;                  // The number of words of the benchmarked length
+        int wordLength;                 // The length of the benchmarked words
+        string name;                    // The name of the benchmark
+        long long operations;           // How many operations were timed
+        double seconds;                 // How long they took altogether
+        long long expandedWords;        // How many words the searches expanded, or 0 if not a search
+        long long allocations;          // How many heap allocations the operations made
+        long long peakMemory;           // The peak resident memory of the process afterwards, in bytes
+    };
+
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor
+    //
+    // minimumSeconds   how long each benchmark runs for, at least; it always runs one full round
+    //
+    LadderBenchmark(double minimumSeconds = 0.5);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Runs every benchmark on the words of the given length in a dictionary file.
+    //
+    // label        the name the results are reported under
+    // fileName     the path to the dictionary
+    // wordLength   the length of the words to benchmark
+    //
+    void runDictionary(const string& label, const string& fileName, int wordLength);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns every result so far, in the order the benchmarks ran.
+    //
+    const vector<Result>& getResults() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the benchmarks that must not allocate but did, each as "dictionary: benchmark", in
+    // the order they ran. Empty if every one of them kept to zero allocations.
+    //
+    const vector<string>& getAllocationFailures() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Writes every result as JSON, one result to a line, so that two runs can be diffed.
+    //
+    void writeJson(ostream& output) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Prints every result of the last dictionary as a table, for a person to read.
+    //
+    void printDictionaryResults(ostream& output) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the peak resident memory (working set, on Windows) of this process, in bytes, or 0
+    // if the platform can't tell us.
+    //
+    static long long getPeakMemory();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the most common word length in a dictionary file, which is the length the benchmarks
+    // use when they aren't told one.
+    //
+    static int getMostCommonLength(const string& fileName);
+
+
+private:
+
+    // The number of queries in each getMinLadder query set, and the number of words in the
+    // lookup sets. The lookups are cheap, so they are timed in rounds over the whole set.
+    //
+    static const int QUERY_COUNT = 64;
+    static const int LOOKUP_COUNT = 4096;
+
+    // The number of words taken out and put back in each round of the update benchmark.
+    static const int UPDATE_COUNT = 16;
+
+    // The seed every query and lookup set is picked with.
+    static const unsigned int QUERY_SEED = 20200425;
+
+    double minimumSeconds;          // How long each benchmark runs for, at least
+    vector<Result> results;         // Every result so far
+    size_t dictionaryStart;         // Where the results of the last dictionary start
+    long long checksum;             // Folds in every answer, so the compiler can't skip the work
+    vector<string> allocationFailures;  // The benchmarks that must not allocate, but did
+
+
+    //---------------------------------------------------------------------------------------------
+    // Runs an operation over and over, in rounds of roundSize calls, until minimumSeconds have
+    // passed, and records the result. The operation is handed the index of the call in its round.
+    //
+    template <typename Operation>
+    Result& measure(const string& name, const Result& context, int roundSize, Operation operation);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Runs every benchmark but the load on a word ladder that has already been loaded.
+    //
+    void runLookupsAndSearches(const Result& context, WordLadder& wordLadder);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Picks the fixed query sets for getMinLadder on a word ladder: short ladders, the longest
+    // ladder from each start word, and pairs in different components (if there are any).
+    //
+    static void pickQueries(const WordLadder& wordLadder, vector<pair<string, string>>& shortQueries,
+        vector<pair<string, string>>& longQueries, vector<pair<string, string>>& unreachableQueries);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Times getMinLadder over a query set, unless the set is empty.
+    //
+    void measureSearches(const string& name, const Result& context, const WordLadder& wordLadder,
+        const vector<pair<string, string>>& queries);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Times the ID-based getMinLadder over a query set, unless the set is empty, formatting every
+    // ladder with the ID-based formatResult. The whole set is answered once before the timing
+    // starts, so that the workspace and buffers have grown to fit before allocations are counted.
+    //
+    void measureIdSearches(const string& name, const Result& context, const WordLadder& wordLadder,
+        const vector<pair<string, string>>& queries);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of heap allocations the process has made so far.
+    //
+    static long long getAllocationCount();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of seconds since the given time.
+    //
+    static double getSecondsSince(chrono::steady_clock::time_point start);
+};
@@ -0,0 +1,155 @@
+//==============================================================================================
+// Main.cpp - Word Ladder benchmark program
+//
+// This program runs the word ladder benchmark suite over synthetic dictionaries of 10 thousand,
+// 100 thousand and 1 million words, followed by any real dictionaries named on the command line,
+// and writes the results to a JSON file, so that versions of the engine can be compared.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "LadderBenchmark.h"
+#include "LexiconGenerator.h"
+
+using namespace std;
+
+// The synthetic dictionaries, written by the lexicon generator. Most of their words are mutations
+// of earlier ones, so that they break up into many components, with ladders as long and as
+// branchy as a real dictionary's, rather than one dense blob.
+//
+struct SyntheticDictionary
+{
+	int wordCount;
+	int wordLength;
+};
+
+const SyntheticDictionary SYNTHETIC_DICTIONARIES[] =
+{
+	{ 10000, 5 },
+	{ 100000, 6 },
+	{ 1000000, 7 },
+};
+
+const double SYNTHETIC_CLUSTERING = 0.85;
+
+int main(int argc, char* argv[])
+{
+	// Every argument is a dictionary to benchmark, except for the
+	// options: "--output" followed by the file to write the JSON
+	// results to (benchmark.json by default), "--length" followed
+	// by the word length to benchmark in the real dictionaries
+	// (their most common length by default), and "--quick", which
+	// skips the million-word dictionary and shortens every timing.
+	//
+	string outputFilePath = "benchmark.json";
+	int wordLength = 0;
+	bool quick = false;
+	vector<string> dictionaryFilePaths;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+
+		if (argument == "--output" && i + 1 < argc)
+		{
+			outputFilePath = argv[++i];
+		}
+		else if (argument == "--length" && i + 1 < argc)
+		{
+			wordLength = atoi(argv[++i]);
+		}
+		else if (argument == "--quick")
+		{
+			quick = true;
+		}
+		else if (argument.compare(0, 2, "--") == 0) // An option we don't know, or one missing its value.
+		{
+			cout << "Unrecognized argument " << argument << ". Example usage:\n";
+			cout << "LadderBenchmark [--quick] [--output results_file_path] [--length word_length] [dictionary_file_path ...]\n";
+
+			return 0;
+		}
+		else
+		{
+			dictionaryFilePaths.push_back(argument);
+		}
+	}
+
+	LadderBenchmark benchmark(quick ? 0.1 : 0.5);
+
+	// The synthetic dictionaries are written out, benchmarked and
+	// deleted one at a time, so they never take up much disk space.
+	for (const SyntheticDictionary& dictionary : SYNTHETIC_DICTIONARIES)
+	{
+		if (quick && dictionary.wordCount > 100000)
+		{
+			continue;
+		}
+
+		LexiconGenerator::Settings settings;
+
+		settings.wordCount = dictionary.wordCount;
+		settings.wordLength = dictionary.wordLength;
+		settings.clustering = SYNTHETIC_CLUSTERING;
+
+		string label = "synthetic-" + to_string(settings.wordCount);
+		string fileName = "benchmark-" + label + ".txt";
+
+		if (!LexiconGenerator(settings).writeFile(fileName))
+		{
+			cout << "Unable to write " << fileName << ".\n";
+
+			return 0;
+		}
+
+		benchmark.runDictionary(label, fileName, settings.wordLength);
+		benchmark.printDictionaryResults(cout);
+
+		remove(fileName.c_str());
+	}
+
+	for (const string& dictionaryFilePath : dictionaryFilePaths)
+	{
+		int length = wordLength > 0 ? wordLength : LadderBenchmark::getMostCommonLength(dictionaryFilePath);
+
+		if (length == 0)
+		{
+			cout << "Unable to read any words from " << dictionaryFilePath << ".\n";
+
+			continue;
+		}
+
+		benchmark.runDictionary(dictionaryFilePath, dictionaryFilePath, length);
+		benchmark.printDictionaryResults(cout);
+	}
+
+	// The ID-based queries are meant to allocate nothing at all
+	// once warmed up, so if any of them did, the run fails, though
+	// the results are still written out to see by how much.
+	int status = benchmark.getAllocationFailures().empty() ? 0 : 1;
+
+	for (const string& failure : benchmark.getAllocationFailures())
+	{
+		cout << "FAILED: " << failure << " made heap allocations, but must make none.\n";
+	}
+
+	ofstream outputFile(outputFilePath);
+
+	if (!outputFile.is_open())
+	{
+		cout << "Unable to open " << outputFilePath << " for writing.\n";
+
+		return status;
+	}
+
+	benchmark.writeJson(outputFile);
+
+	cout << "Wrote the results to " << outputFilePath << ".\n";
+
+	return status;
+}
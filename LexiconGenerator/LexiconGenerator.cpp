@@ -0,0 +1,244 @@
+//==============================================================================================
+// File: LexiconGenerator.cpp - Synthetic lexicon generator implementation
+// c.f.: LexiconGenerator.h
+//
+// This class generates lexicons of distinct random words, some drawn
+// uniformly and some mutated from earlier words, to test the word
+// ladder engine at any size and density, reproducibly.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "LexiconGenerator.h"
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+string LexiconGenerator::checkSettings(const Settings& settings)
+{
+	if (settings.wordLength < 1)
+	{
+		return "The word length must be at least 1.";
+	}
+
+	if (settings.alphabetSize < 2 || settings.alphabetSize > 26)
+	{
+		return "The alphabet size must be from 2 to 26.";
+	}
+
+	if (settings.wordCount < 0)
+	{
+		return "The word count can't be negative.";
+	}
+
+	if (settings.clustering < 0 || settings.clustering > 1)
+	{
+		return "The clustering must be from 0 to 1.";
+	}
+
+	// There are only so many distinct words of a given length.
+	// We multiply up the alphabet size no further than we need
+	// to, so the product can't overflow.
+	double possibleWords = 1;
+
+	for (int i = 0; i < settings.wordLength && possibleWords < settings.wordCount; i++)
+	{
+		possibleWords *= settings.alphabetSize;
+	}
+
+	if (possibleWords < settings.wordCount)
+	{
+		return "There are only " + to_string((long long)possibleWords) + " possible words of that length and alphabet.";
+	}
+
+	return "";
+}
+
+LexiconGenerator::LexiconGenerator(const Settings& settings)
+{
+	// The constructor does the generating. When steering towards a
+	// target degree, we keep count of how many words share each
+	// pattern (a word with one letter left out), since a new word
+	// gains one neighbor for every earlier word sharing one of its
+	// patterns. While the average degree is below the target, we
+	// mutate, which always adds a neighbor; once it's above, we
+	// draw uniformly, which usually doesn't.
+	//
+	this->settings = settings;
+	randomState = settings.seed;
+
+	bool steering = settings.targetDegree >= 0;
+	unordered_set<string> generated;
+	unordered_map<uint64_t, int> patternCounts;
+	long long edgeCount = 0;
+	string word(settings.wordLength, 'A');
+
+	generated.reserve(settings.wordCount);
+
+	while ((int)words.size() < settings.wordCount)
+	{
+		bool mutate;
+
+		if (steering)
+		{
+			mutate = !words.empty() && 2.0 * edgeCount / words.size() < settings.targetDegree;
+		}
+		else
+		{
+			mutate = !words.empty() && nextProbability() < settings.clustering;
+		}
+
+		if (mutate) // We change one letter of an earlier word to a different letter,
+		{
+			word = words[nextRandom((int)words.size())];
+
+			int position = nextRandom(settings.wordLength);
+
+			word[position] = 'A' + (word[position] - 'A' + 1 + nextRandom(settings.alphabetSize - 1)) % settings.alphabetSize;
+		}
+		else // or draw every letter at random.
+		{
+			for (int i = 0; i < settings.wordLength; i++)
+			{
+				word[i] = 'A' + nextRandom(settings.alphabetSize);
+			}
+		}
+
+		if (!generated.insert(word).second) // We already have this word, so we try again.
+		{
+			continue;
+		}
+
+		words.push_back(word);
+
+		if (steering)
+		{
+			for (int position = 0; position < settings.wordLength; position++)
+			{
+				edgeCount += patternCounts[getPatternHash(word, position)]++;
+			}
+		}
+	}
+
+	sort(words.begin(), words.end());
+
+	countNeighbors();
+}
+
+const vector<string>& LexiconGenerator::getWords() const
+{
+	return words;
+}
+
+bool LexiconGenerator::writeFile(const string& fileName) const
+{
+	ofstream file(fileName);
+
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	for (const string& word : words)
+	{
+		file << word << "\n";
+	}
+
+	return true;
+}
+
+double LexiconGenerator::getAverageDegree() const
+{
+	return averageDegree;
+}
+
+int LexiconGenerator::getIsolatedCount() const
+{
+	return isolatedCount;
+}
+
+uint64_t LexiconGenerator::nextRandom()
+{
+	// This is SplitMix64, which is tiny, fast, and gives the same
+	// numbers everywhere, unlike the standard distributions.
+	//
+	uint64_t z = (randomState += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+	return z ^ (z >> 31);
+}
+
+int LexiconGenerator::nextRandom(int limit)
+{
+	return (int)(nextRandom() % limit);
+}
+
+double LexiconGenerator::nextProbability()
+{
+	return (nextRandom() >> 11) * (1.0 / 9007199254740992.0); // The top 53 bits, over 2^53
+}
+
+uint64_t LexiconGenerator::getPatternHash(const string& word, int position)
+{
+	// FNV-1a, with a wildcard in place of the letter left out.
+	//
+	uint64_t hash = 0xCBF29CE484222325ULL;
+
+	for (int i = 0; i < (int)word.length(); i++)
+	{
+		hash ^= (unsigned char)(i == position ? '*' : word[i]);
+		hash *= 0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+void LexiconGenerator::countNeighbors()
+{
+	// We go one position at a time. Sorting the words by their
+	// pattern at that position gathers the words that differ only
+	// there into runs, and a run of g words gives each of them
+	// g - 1 neighbors.
+	//
+	vector<bool> hasNeighbor(words.size(), false);
+	vector<pair<uint64_t, int>> patterns(words.size());
+	long long degreeTotal = 0;
+
+	for (int position = 0; position < settings.wordLength; position++)
+	{
+		for (int i = 0; i < (int)words.size(); i++)
+		{
+			patterns[i] = make_pair(getPatternHash(words[i], position), i);
+		}
+
+		sort(patterns.begin(), patterns.end());
+
+		for (size_t runStart = 0; runStart < patterns.size();)
+		{
+			size_t runEnd = runStart + 1;
+
+			while (runEnd < patterns.size() && patterns[runEnd].first == patterns[runStart].first)
+			{
+				runEnd++;
+			}
+
+			long long runLength = runEnd - runStart;
+
+			degreeTotal += runLength * (runLength - 1);
+
+			for (size_t i = runStart; i < runEnd && runLength > 1; i++)
+			{
+				hasNeighbor[patterns[i].second] = true;
+			}
+
+			runStart = runEnd;
+		}
+	}
+
+	averageDegree = words.empty() ? 0 : (double)degreeTotal / words.size();
+	isolatedCount = (int)count(hasNeighbor.begin(), hasNeighbor.end(), false);
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// LexiconGenerator.h Defines a generator of synthetic lexicons, for testing the word ladder engine at
+// sizes and shapes no real dictionary has. A generated lexicon is written in the same format the
+// WordLadder constructor reads: uppercase words, one to a line.
+//
+// Every word is drawn from the first alphabetSize letters of the alphabet, in one of two ways:
+// uniformly at random, or by changing one letter of a word already generated, which makes the new
+// word its neighbor. Uniform words alone give a graph whose density depends only on how much of the
+// space of possible words is filled; mutated words grow clusters around the words they came from,
+// much like the families of related words in a real dictionary. How often each is used is set
+// either by a clustering probability, or by a target average degree (the average number of
+// neighbors a word has), which the generator steers towards as it goes.
+//
+// The generator is deterministic: the same settings and seed always give the same lexicon, on
+// every platform, since it uses its own random number generator (SplitMix64) rather than the
+// standard library's distributions.
+//
+
+using namespace std;
+
+class LexiconGenerator
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // The settings of a lexicon.
+    //
+    struct Settings
+    {
+        int wordLength = 5;             // The length of every word
+        int alphabetSize = 26;          // How many letters, starting from A, the words use
+        int wordCount = 10000;          // How many distinct words to generate
+        double clustering = 0;          // The chance each word is a mutation of an earlier one
+        double targetDegree = -1;       // The average degree to steer towards, if not negative,
+                                        // in place of clustering
+        uint64_t seed = 1;              // The seed of the random number generator
+    };
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a description of what is wrong with the given settings, or an empty string if they
+    // can be generated.
+    //
+    static string checkSettings(const Settings& settings);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- generates a lexicon with the given settings, which must pass checkSettings
+    //
+    LexiconGenerator(const Settings& settings);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the generated words, in alphabetical order.
+    //
+    const vector<string>& getWords() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Writes the generated words to a file, one to a line.
+    //
+    // returns  true if the file was written, false if it couldn't be opened
+    //
+    bool writeFile(const string& fileName) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the average number of neighbors of the generated words.
+    //
+    double getAverageDegree() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of generated words with no neighbors at all.
+    //
+    int getIsolatedCount() const;
+
+
+private:
+
+    Settings settings;              // The settings the lexicon was generated with
+    vector<string> words;           // The generated words
+    double averageDegree;           // The average number of neighbors of a word
+    int isolatedCount;              // The number of words without neighbors
+    uint64_t randomState;           // The state of the SplitMix64 generator
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the next 64 random bits.
+    //
+    uint64_t nextRandom();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a random integer from 0 up to (but not including) limit.
+    //
+    int nextRandom(int limit);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a random number from 0 up to (but not including) 1.
+    //
+    double nextProbability();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a hash of the given word with the letter at position left out. Barring collisions,
+    // two different words are neighbors exactly when they have the same hash at some position.
+    //
+    static uint64_t getPatternHash(const string& word, int position);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Counts the neighbors of every generated word, to fill in averageDegree and isolatedCount.
+    //
+    void countNeighbors();
+};
@@ -0,0 +1,91 @@
+//==============================================================================================
+// Main.cpp - Synthetic lexicon generator program
+//
+// This program writes a synthetic dictionary file for the word ladder program to read, with as
+// many words as we like, of whatever length, alphabet and density, so that loading, memory and
+// queries can be measured at any scale, reproducibly.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include <iostream>
+#include <string>
+#include "LexiconGenerator.h"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+	// The first argument is the file to write; every other
+	// argument is an option followed by its value. Whatever isn't
+	// given keeps the default from LexiconGenerator::Settings.
+	//
+	LexiconGenerator::Settings settings;
+	bool validArguments = argc >= 2 && argc % 2 == 0;
+
+	for (int i = 2; validArguments && i + 1 < argc; i += 2)
+	{
+		string option = argv[i];
+		string value = argv[i + 1];
+
+		if (option == "--length")
+		{
+			settings.wordLength = atoi(value.c_str());
+		}
+		else if (option == "--alphabet")
+		{
+			settings.alphabetSize = atoi(value.c_str());
+		}
+		else if (option == "--count")
+		{
+			settings.wordCount = atoi(value.c_str());
+		}
+		else if (option == "--clustering")
+		{
+			settings.clustering = atof(value.c_str());
+		}
+		else if (option == "--degree")
+		{
+			settings.targetDegree = atof(value.c_str());
+		}
+		else if (option == "--seed")
+		{
+			settings.seed = strtoull(value.c_str(), nullptr, 10);
+		}
+		else
+		{
+			validArguments = false;
+		}
+	}
+
+	if (!validArguments)
+	{
+		cout << "Wrong arguments provided. Example usage:\n";
+		cout << "LexiconGenerator output_file_path [--length n] [--alphabet n] [--count n] [--clustering p | --degree d] [--seed n]\n";
+
+		return 0;
+	}
+
+	string problem = LexiconGenerator::checkSettings(settings);
+
+	if (!problem.empty())
+	{
+		cout << problem << "\n";
+
+		return 0;
+	}
+
+	LexiconGenerator generator(settings);
+
+	if (!generator.writeFile(argv[1]))
+	{
+		cout << "Unable to open " << argv[1] << " for writing.\n";
+
+		return 0;
+	}
+
+	cout << "Wrote " << generator.getWords().size() << " words of " << settings.wordLength << " letters to " << argv[1] << ", ";
+	cout << "with an average of " << generator.getAverageDegree() << " neighbors and " << generator.getIsolatedCount() << " words without any.\n";
+
+	return 0;
+}
@@ -0,0 +1,276 @@
+//==============================================================================================
+// File: BatchSolver.cpp - Batch word ladder solver implementation
+// c.f.: BatchSolver.h
+//
+// This class answers a whole batch of word ladder queries against one
+// WordLadder. The queries are grouped by their start word, and each
+// group is answered by a single breadth-first search, so a batch costs
+// one search per distinct start word instead of one per query. The
+// groups are spread across a pool of worker threads that steal work
+// from each other once their own runs out.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "BatchSolver.h"
+#include <chrono>
+#include <map>
+
+BatchSolver::BatchSolver(const WordLadder& wordLadder, int threadCount) : wordLadder(wordLadder)
+{
+	// The constructor starts up the pool of worker threads. They
+	// wait for batches for as long as the solver lives, so that
+	// their threads and workspaces are only ever set up once.
+	//
+	batchNumber = 0;
+	busyWorkers = 0;
+	stopping = false;
+	batchQueries = nullptr;
+	batchGroups = nullptr;
+	batchLadders = nullptr;
+
+	if (threadCount <= 0) // If we weren't told how many threads to use,
+	{
+		// we use one per hardware thread. The standard allows
+		// hardware_concurrency to return zero if it can't tell,
+		// in which case we make do with a single thread.
+		threadCount = thread::hardware_concurrency();
+
+		if (threadCount <= 0)
+		{
+			threadCount = 1;
+		}
+	}
+
+	// Every worker has to exist before any thread starts, since
+	// a thread may try to steal from the others straight away.
+	for (int i = 0; i < threadCount; i++)
+	{
+		workers.push_back(new Worker());
+	}
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		workers[i]->workerThread = thread(&BatchSolver::runWorker, this, i);
+	}
+}
+
+BatchSolver::~BatchSolver()
+{
+	// The destructor tells every worker to stop, wakes them
+	// all up so that they notice, and waits for them to exit
+	// before freeing them.
+	//
+	{
+		lock_guard<mutex> guard(batchLock);
+
+		stopping = true;
+	}
+
+	batchReady.notify_all();
+
+	for (Worker* worker : workers)
+	{
+		worker->workerThread.join();
+
+		delete worker;
+	}
+}
+
+int BatchSolver::getThreadCount() const
+{
+	return workers.size();
+}
+
+WordLadder::SearchStatistics BatchSolver::getStatistics() const
+{
+	WordLadder::SearchStatistics total;
+
+	for (const Worker* worker : workers)
+	{
+		total.add(worker->workspace.statistics);
+	}
+
+	return total;
+}
+
+LatencyHistogram BatchSolver::getLatencies() const
+{
+	LatencyHistogram total;
+
+	for (const Worker* worker : workers)
+	{
+		total.merge(worker->latencies);
+	}
+
+	return total;
+}
+
+vector<vector<string>> BatchSolver::solve(const vector<pair<string, string>>& queries)
+{
+	// This method answers every query in the batch. We first
+	// group the queries by their start word, remembering where
+	// each one came from, then deal the groups out to the workers
+	// and wait for them to finish.
+	//
+	vector<vector<string>> ladders(queries.size());
+
+	// For every start word, we keep the positions of the queries that begin with it.
+	map<string, vector<int>> queriesByStart;
+
+	for (unsigned int i = 0; i < queries.size(); i++)
+	{
+		queriesByStart[queries[i].first].push_back(i);
+	}
+
+	vector<pair<string, vector<int>>> groups(queriesByStart.begin(), queriesByStart.end());
+
+	// We deal the groups out round-robin, so every worker starts with
+	// about the same amount of work.
+	for (unsigned int i = 0; i < groups.size(); i++)
+	{
+		Worker* worker = workers[i % workers.size()];
+
+		lock_guard<mutex> guard(worker->taskLock);
+
+		worker->tasks.push_back(i);
+	}
+
+	unique_lock<mutex> lock(batchLock);
+
+	batchQueries = &queries;
+	batchGroups = &groups;
+	batchLadders = &ladders;
+	busyWorkers = workers.size();
+	batchNumber++;
+
+	batchReady.notify_all(); // Every worker is waiting for a new batch number, so we wake them all.
+
+	// We wait for the last worker to report that it has run out of work.
+	batchDone.wait(lock, [this] { return busyWorkers == 0; });
+
+	batchQueries = nullptr;
+	batchGroups = nullptr;
+	batchLadders = nullptr;
+
+	return ladders;
+}
+
+void BatchSolver::runWorker(int workerIndex)
+{
+	// This method is the body of every worker thread. A worker
+	// sleeps until a new batch is handed out, answers tasks until
+	// there are none left anywhere, reports that it is done, and
+	// goes back to sleep.
+	//
+	Worker& worker = *workers[workerIndex];
+	unsigned int lastBatch = 0; // The last batch this worker took part in
+
+	while (true)
+	{
+		{
+			unique_lock<mutex> lock(batchLock);
+
+			batchReady.wait(lock, [&] { return stopping || batchNumber != lastBatch; });
+
+			if (stopping)
+			{
+				return;
+			}
+
+			lastBatch = batchNumber;
+		}
+
+		int groupIndex;
+
+		while ((groupIndex = takeTask(workerIndex)) != -1)
+		{
+			answerGroup(groupIndex, worker);
+		}
+
+		lock_guard<mutex> guard(batchLock);
+
+		busyWorkers--;
+
+		if (busyWorkers == 0) // If we were the last worker still going, the batch is done.
+		{
+			batchDone.notify_one();
+		}
+	}
+}
+
+int BatchSolver::takeTask(int workerIndex)
+{
+	// This method finds the next task for a worker. A worker
+	// takes from the back of its own deque, and steals from the
+	// front of everyone else's, starting with its neighbor, so that
+	// the owner and the thief are working at opposite ends.
+	//
+	Worker& worker = *workers[workerIndex];
+
+	{
+		lock_guard<mutex> guard(worker.taskLock);
+
+		if (!worker.tasks.empty())
+		{
+			int task = worker.tasks.back();
+
+			worker.tasks.pop_back();
+
+			return task;
+		}
+	}
+
+	int workerCount = workers.size();
+
+	for (int offset = 1; offset < workerCount; offset++)
+	{
+		Worker& victim = *workers[(workerIndex + offset) % workerCount];
+
+		lock_guard<mutex> guard(victim.taskLock);
+
+		if (!victim.tasks.empty())
+		{
+			int task = victim.tasks.front();
+
+			victim.tasks.pop_front();
+
+			return task;
+		}
+	}
+
+	// No task is ever added in the middle of a batch, so once every
+	// deque is empty, there is nothing left for this worker to do.
+	return -1;
+}
+
+void BatchSolver::answerGroup(int groupIndex, Worker& worker)
+{
+	// This method answers one group of queries that share a start
+	// word. We collect the group's end words in the same order as
+	// its query positions, answer them all with one search, and
+	// put each ladder back where its query came from. No two groups
+	// share a query, so no two workers ever write the same ladder.
+	//
+	const pair<string, vector<int>>& group = (*batchGroups)[groupIndex];
+
+	vector<string> ends;
+
+	for (int queryIndex : group.second)
+	{
+		ends.push_back((*batchQueries)[queryIndex].second);
+	}
+
+	LADDER_STATS(chrono::steady_clock::time_point groupStart = chrono::steady_clock::now());
+
+	vector<vector<string>> groupLadders = wordLadder.getMinLadders(group.first, ends, worker.workspace);
+
+	LADDER_STATS(chrono::duration<double> groupDuration = chrono::steady_clock::now() - groupStart);
+
+	LADDER_STATS(worker.latencies.record(groupDuration.count(), group.second.size()));
+
+	for (unsigned int i = 0; i < group.second.size(); i++)
+	{
+		(*batchLadders)[group.second[i]].swap(groupLadders[i]);
+	}
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "LatencyHistogram.h"
+#include "WordLadder.h"
+
+//
+// BatchSolver.h Defines a solver that answers many word ladder queries against a single, already
+// loaded WordLadder.
+//
+// Loading the lexicon and building its neighbor index is by far the most expensive part of answering
+// a query, so a batch of queries should pay for it once. Queries that share a start word are also
+// answered together, from a single breadth-first search tree rooted at that word.
+//
+// Once built, a WordLadder is read-only, so the solver answers queries on a pool of worker threads
+// that all share it. Each worker owns its own search workspace, which it reuses for every query it
+// answers, across batches. The work of a batch is dealt out evenly between the workers up front,
+// and a worker that runs out steals from the others, so an unlucky worker stuck with the long
+// searches doesn't hold up the whole batch.
+//
+// Every query in a batch must use words of the length the WordLadder was constructed with; any
+// other query simply has no ladder.
+//
+// Unless WORD_LADDER_STATS compiled them out, the solver keeps the search statistics of every
+// query it has answered, and a histogram of their latencies. A query's latency is the time taken
+// by the search for its whole group, since none of the group's ladders is ready any sooner.
+//
+
+using namespace std;
+
+class BatchSolver
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- the solver answers every query against the given word ladder, which must stay
+    // alive, and unchanged, for as long as the solver does
+    //
+    // threadCount  the number of worker threads; 0 uses one per hardware thread
+    //
+    BatchSolver(const WordLadder& wordLadder, int threadCount = 0);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Destructor -- stops and joins the worker threads
+    //
+    ~BatchSolver();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Answers every query in the batch. Each ladder follows the contract of
+    // WordLadder::getMinLadder, so a query with no ladder gets an empty one.
+    //
+    // queries  the (start, end) pairs to answer
+    // returns  one ladder per query, in the same order as the queries
+    //
+    vector<vector<string>> solve(const vector<pair<string, string>>& queries);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of worker threads in the pool.
+    //
+    int getThreadCount() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the search statistics of every query answered so far, added up over the workers.
+    // Must not be called while a batch is being solved.
+    //
+    WordLadder::SearchStatistics getStatistics() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the latencies of every query answered so far. Must not be called while a batch is
+    // being solved.
+    //
+    LatencyHistogram getLatencies() const;
+
+
+private:
+
+    //---------------------------------------------------------------------------------------------
+    // A worker thread, along with the tasks it has been dealt and its own search workspace. A task
+    // is the index of a group of queries that share a start word. The owner takes tasks from the
+    // back of its deque, while thieves take them from the front.
+    //
+    struct Worker
+    {
+        mutex taskLock;                         // Guards tasks, which thieves also touch
+        deque<int> tasks;                       // The tasks still waiting to be answered
+        WordLadder::SearchWorkspace workspace;  // Reused by every search this worker runs
+        LatencyHistogram latencies;             // The latency of every query this worker answered
+        thread workerThread;
+    };
+
+    const WordLadder& wordLadder;   // The word ladder every query is answered against
+    vector<Worker*> workers;        // The pool, one entry per thread
+
+    mutex batchLock;                // Guards everything below
+    condition_variable batchReady;  // Signalled when a batch is handed out, or the pool is stopping
+    condition_variable batchDone;   // Signalled when the last worker finishes a batch
+    unsigned int batchNumber;       // Counts batches, so workers can tell a new one has arrived
+    int busyWorkers;                // How many workers are still working on the current batch
+    bool stopping;                  // Set by the destructor to tell the workers to exit
+
+    // The batch being answered. Each group holds the start word shared by its queries, and the
+    // positions of those queries; the workers write each ladder straight into its position.
+    //
+    const vector<pair<string, string>>* batchQueries;
+    vector<pair<string, vector<int>>>* batchGroups;
+    vector<vector<string>>* batchLadders;
+
+
+    //---------------------------------------------------------------------------------------------
+    // The loop each worker thread runs until the pool is stopped.
+    //
+    void runWorker(int workerIndex);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Takes the next task for the given worker, from its own deque first, then from the others.
+    //
+    // returns  the group index of the task, or -1 if there is no work left anywhere
+    //
+    int takeTask(int workerIndex);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Answers every query of one group with the given worker's workspace.
+    //
+    void answerGroup(int groupIndex, Worker& worker);
+
+};
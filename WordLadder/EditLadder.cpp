@@ -0,0 +1,408 @@
+//==============================================================================================
+// File: EditLadder.cpp - Word ladders with insertions and deletions
+// c.f.: EditLadder.h
+//
+// This class finds word ladders in which each step may add, remove or
+// change a letter, searching the words of every length in a lexicon.
+// Neighbors come from an index of every word's single-letter deletions,
+// so finding them never means scanning the lexicon.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "EditLadder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+EditLadder::EditLadder(Lexicon& lexicon) : lexicon(lexicon)
+{
+	// The constructor numbers the words of every length one after
+	// another, so that a single ID, and a single workspace, covers
+	// them all. Then it files every word under each of its keys.
+	//
+	vector<int> lengths = lexicon.getWordLengths();
+	int maxLength = lengths.empty() ? 0 : lengths.back();
+
+	partitions.assign(maxLength + 1, nullptr);
+	firstIds.assign(maxLength + 2, 0);
+
+	for (int length : lengths)
+	{
+		if (length > 0) // An empty word has nothing to delete, and nowhere to go.
+		{
+			partitions[length] = &lexicon.getWordLadder(length);
+		}
+	}
+
+	for (int length = 0; length <= maxLength; length++)
+	{
+		firstIds[length + 1] = firstIds[length] + (partitions[length] != nullptr ? partitions[length]->getWordCount() : 0);
+	}
+
+	wordCount = firstIds[maxLength + 1];
+
+	// The IDs only need enough bits to count every word, which
+	// leaves the rest of each entry to the hash.
+	idBits = 1;
+
+	while (idBits < 31 && (1LL << idBits) < wordCount)
+	{
+		idBits++;
+	}
+
+	chrono::steady_clock::time_point buildStart = chrono::steady_clock::now();
+
+	size_t keyCount = 0;
+
+	for (int length = 1; length <= maxLength; length++)
+	{
+		keyCount += (size_t)(firstIds[length + 1] - firstIds[length]) * (length + 1);
+	}
+
+	deletions.reserve(keyCount);
+
+	for (int id = 0; id < wordCount; id++)
+	{
+		const char* word;
+		int length = getWord(id, word);
+
+		for (int position = 0; position <= length; position++)
+		{
+			// Deleting either letter of a doubled pair leaves the same
+			// key, so only the first of the pair is filed.
+			if (position > 0 && position < length && word[position] == word[position - 1])
+			{
+				continue;
+			}
+
+			deletions.push_back(hashKey(word, length, position) | (unsigned long long)id);
+		}
+	}
+
+	sort(deletions.begin(), deletions.end());
+
+	// The hashes are spread evenly, so a directory with at least
+	// a slot for every entry leaves about one entry per slot, or
+	// fewer. Each slot records where its entries start.
+	directoryBits = 1;
+
+	while (directoryBits < 30 && ((size_t)1 << directoryBits) < deletions.size())
+	{
+		directoryBits++;
+	}
+
+	size_t slotCount = (size_t)1 << directoryBits;
+	size_t entry = 0;
+
+	deletionStarts.resize(slotCount + 1);
+
+	for (size_t slot = 0; slot < slotCount; slot++)
+	{
+		deletionStarts[slot] = (unsigned int)entry;
+
+		while (entry < deletions.size() && (deletions[entry] >> (64 - directoryBits)) == slot)
+		{
+			entry++;
+		}
+	}
+
+	deletionStarts[slotCount] = (unsigned int)deletions.size();
+
+	indexBuildTime = chrono::duration<double>(chrono::steady_clock::now() - buildStart).count();
+}
+
+unsigned long long EditLadder::hashKey(const char* word, int length, int position) const
+{
+	// This method hashes the key with FNV-1a, skipping the deleted
+	// letter, and starting from the key's length, so that keys of
+	// different lengths rarely share a hash. FNV-1a leaves its low
+	// bits poorly mixed, and those are the ones the ID replaces, so
+	// a final round of the splitmix64 mixer spreads every letter
+	// into the high bits we keep.
+	//
+	unsigned long long hash = 14695981039346656037ULL ^ (unsigned long long)(length - (position < length));
+
+	for (int i = 0; i < length; i++)
+	{
+		if (i != position)
+		{
+			hash = (hash ^ (unsigned char)word[i]) * 1099511628211ULL;
+		}
+	}
+
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+	hash ^= hash >> 31;
+
+	return hash & ~((1ULL << idBits) - 1);
+}
+
+template <typename Visitor>
+void EditLadder::forEachNeighbor(int id, Visitor visit) const
+{
+	// This method looks up each of the word's keys in the index.
+	// Every word filed under the same hash is a candidate, and the
+	// ones that really are a single edit away are visited.
+	//
+	unsigned long long idMask = (1ULL << idBits) - 1;
+	const char* word;
+	int length = getWord(id, word);
+
+	for (int position = 0; position <= length; position++)
+	{
+		// A doubled letter gives the same key twice, just as when
+		// the index was built, so we only look it up once.
+		if (position > 0 && position < length && word[position] == word[position - 1])
+		{
+			continue;
+		}
+
+		// The directory narrows the search down to the entries that
+		// share the top bits of the hash, which are only a few.
+		unsigned long long hash = hashKey(word, length, position);
+		size_t slot = (size_t)(hash >> (64 - directoryBits));
+		const unsigned long long* slotEnd = deletions.data() + deletionStarts[slot + 1];
+		const unsigned long long* entry = lower_bound(deletions.data() + deletionStarts[slot], slotEnd, hash);
+
+		for (; entry != slotEnd && (*entry & ~idMask) == hash; entry++)
+		{
+			int candidate = (int)(*entry & idMask);
+
+			if (candidate == id)
+			{
+				continue;
+			}
+
+			const char* candidateWord;
+			int candidateLength = getWord(candidate, candidateWord);
+
+			if (isOneEdit(word, length, candidateWord, candidateLength))
+			{
+				visit(candidate);
+			}
+		}
+	}
+}
+
+vector<string> EditLadder::getMinLadder(const string& start, const string& end)
+{
+	return getMinLadder(start, end, workspace);
+}
+
+vector<string> EditLadder::getMinLadder(const string& start, const string& end, WordLadder::SearchWorkspace& state) const
+{
+	// This method finds the shortest edit ladder between the two
+	// words with the same breadth-first search WordLadder uses, over
+	// the global IDs, with neighbors coming from the deletion index.
+	//
+	vector<string> ladder;
+
+	LADDER_STATS(state.statistics.queries++);
+
+	int startId = getWordId(start.data(), start.length());
+	int endId = getWordId(end.data(), end.length());
+
+	if (startId == -1 || endId == -1 || startId == endId)
+	{
+		return ladder;
+	}
+
+	LADDER_STATS(chrono::steady_clock::time_point searchStart = chrono::steady_clock::now());
+
+	// The workspace is sized by the words of every length, since
+	// the search can reach any of them.
+	bool foundEnd = state.breadthFirstSearch(wordCount, startId, endId, [this](int id, auto visit)
+	{
+		forEachNeighbor(id, visit);
+	});
+
+	LADDER_STATS(chrono::steady_clock::time_point searchEnd = chrono::steady_clock::now());
+
+	// If we reached the end word, we walk its parents back to the
+	// start, and turn the backwards ladder around.
+	if (foundEnd)
+	{
+		for (int id = endId; id != -1; id = state.parents[id])
+		{
+			const char* word;
+			int length = getWord(id, word);
+
+			ladder.push_back(string(word, length));
+		}
+
+		reverse(ladder.begin(), ladder.end());
+	}
+
+	LADDER_STATS(state.statistics.dequeuedWords += state.expandedWords);
+	LADDER_STATS(state.statistics.searchSeconds += chrono::duration<double>(searchEnd - searchStart).count());
+	LADDER_STATS(state.statistics.reconstructSeconds += chrono::duration<double>(chrono::steady_clock::now() - searchEnd).count());
+
+	return ladder;
+}
+
+vector<string> EditLadder::getNeighbors(const string& word) const
+{
+	// A neighbor can share more than one key with the word, so we
+	// collect the IDs first and drop any repeats. IDs are numbered
+	// by length and then in each partition's sorted order, so
+	// sorting them sorts the words too.
+	//
+	vector<string> neighbors;
+	int id = getWordId(word.data(), word.length());
+
+	if (id == -1)
+	{
+		return neighbors;
+	}
+
+	vector<int> neighborIds;
+
+	forEachNeighbor(id, [&](int neighbor)
+	{
+		neighborIds.push_back(neighbor);
+	});
+
+	sort(neighborIds.begin(), neighborIds.end());
+	neighborIds.erase(unique(neighborIds.begin(), neighborIds.end()), neighborIds.end());
+
+	for (int neighbor : neighborIds)
+	{
+		const char* neighborWord;
+		int length = getWord(neighbor, neighborWord);
+
+		neighbors.push_back(string(neighborWord, length));
+	}
+
+	return neighbors;
+}
+
+int EditLadder::getWordCount() const
+{
+	return wordCount;
+}
+
+double EditLadder::getIndexBuildTime() const
+{
+	return indexBuildTime;
+}
+
+WordLadder::SearchStatistics EditLadder::getStatistics() const
+{
+	return workspace.statistics;
+}
+
+int EditLadder::getWordId(const char* text, size_t length) const
+{
+	if (length >= partitions.size() || partitions[length] == nullptr)
+	{
+		return -1;
+	}
+
+	int localId = partitions[length]->getWordId(text, length);
+
+	return localId == -1 ? -1 : firstIds[length] + localId;
+}
+
+int EditLadder::getWord(int id, const char*& text) const
+{
+	// The first IDs only go up with the length, so the word's
+	// length is the last one whose first ID isn't past it.
+	//
+	int length = (int)(upper_bound(firstIds.begin(), firstIds.end(), id) - firstIds.begin()) - 1;
+
+	text = partitions[length]->getWordData(id - firstIds[length]);
+
+	return length;
+}
+
+bool EditLadder::isOneEdit(const char* first, size_t firstLength, const char* second, size_t secondLength)
+{
+	// Two strings of the same length are one edit apart when they
+	// differ in exactly one place. Otherwise, the longer one must
+	// be the shorter one with a single letter inserted: past their
+	// common prefix, the rest of the longer one, less its next
+	// letter, must match the rest of the shorter one.
+	//
+	if (firstLength == secondLength)
+	{
+		int mismatches = 0;
+
+		for (size_t i = 0; i < firstLength && mismatches < 2; i++)
+		{
+			mismatches += first[i] != second[i];
+		}
+
+		return mismatches == 1;
+	}
+
+	if (firstLength < secondLength)
+	{
+		swap(first, second);
+		swap(firstLength, secondLength);
+	}
+
+	if (firstLength != secondLength + 1)
+	{
+		return false;
+	}
+
+	size_t prefix = 0;
+
+	while (prefix < secondLength && first[prefix] == second[prefix])
+	{
+		prefix++;
+	}
+
+	return memcmp(first + prefix + 1, second + prefix, secondLength - prefix) == 0;
+}
+
+bool EditLadder::isEditLadder(const vector<string>& sequence)
+{
+	if (sequence.size() < 2)
+	{
+		return false;
+	}
+
+	for (size_t i = 1; i < sequence.size(); i++)
+	{
+		if (!isOneEdit(sequence[i - 1].data(), sequence[i - 1].length(), sequence[i].data(), sequence[i].length()))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+string EditLadder::formatResult(const vector<string>& sequence)
+{
+	// This method describes the ladder in the very same words as
+	// WordLadder::formatResult, so both kinds of ladder read alike.
+	//
+	if (sequence.empty())
+	{
+		return "Word Ladder is empty - No Solution\n";
+	}
+
+	if (!isEditLadder(sequence))
+	{
+		return "Word Ladder is invalid - the sequence passed in is not a valid word ladder.\n";
+	}
+
+	string result = "A Shortest Word Ladder (" + to_string(sequence.size() - 1) + " steps) is: ";
+
+	for (size_t i = 0; i < sequence.size(); i++)
+	{
+		result += sequence[i];
+		result += i + 1 < sequence.size() ? " " : "\n";
+	}
+
+	return result;
+}
+
+void EditLadder::displayResult(const vector<string>& sequence)
+{
+	cout << formatResult(sequence);
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Lexicon.h"
+#include "WordLadder.h"
+
+//
+// EditLadder.h Defines word ladders in which a step may insert or delete a letter, as well as change
+// one, so that a ladder can pass through words of different lengths -- CAT, CART, CARD, for example.
+// Two words are neighbors when their edit (Levenshtein) distance is exactly one.
+//
+// A WordLadder only holds the words of one length, so an EditLadder searches every partition of a
+// Lexicon at once. Each word gets a global ID: the words of each length are numbered in order of
+// length, and within a length in the partition's own order.
+//
+// Trying every possible edit of a word would mean looking up 26 * (2L + 1) strings, and comparing it
+// with every word would mean scanning the whole lexicon. Neighbors are instead found through a
+// deletion-neighborhood index, as in the SymSpell spelling corrector: every word is filed under
+// itself and under each of the L strings left by deleting one of its letters. Two words are one
+// edit apart only if they share one of those keys: a changed letter leaves both with the same
+// deletion, and an inserted letter, once deleted again, leaves the shorter word itself. So a word's
+// neighbors are among the words filed under its own L + 1 keys, each found with a binary search,
+// and each is checked before it counts, since sharing a key doesn't always mean one edit apart
+// (ABC and BAC both become BC).
+//
+// The index is an array with one 64-bit entry per key of every word, sorted: the high bits hold a
+// hash of the key, and the low bits the word's ID, so a lexicon of a million words of about eight
+// letters takes around 72 MiB, plus a directory into it by the top bits of the hash that takes
+// between half as much again and as much again.
+//
+
+using namespace std;
+
+class EditLadder
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- builds every partition of the given lexicon that isn't built yet, then the
+    // deletion index over all of their words. The lexicon must stay alive, and unchanged, for as
+    // long as the EditLadder does. Its partitions' neighbor indexes aren't used here, so a lexicon
+    // built with WordLadder::SCAN_ENGINE, which builds none, is the cheapest to start from.
+    //
+    EditLadder(Lexicon& lexicon);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a minimum-length ladder from start to end in which every step inserts, deletes or
+    // changes one letter, found with a breadth-first search. It otherwise follows the contract of
+    // WordLadder::getMinLadder: if start or end isn't a word, or they are the same word, or there
+    // is no ladder, the result is empty.
+    //
+    vector<string> getMinLadder(const string& start, const string& end);
+
+
+    //---------------------------------------------------------------------------------------------
+    // The same query, searching with the caller's workspace, which is sized by the number of words
+    // of every length. Safe to call from several threads at once, as long as no two threads share
+    // a workspace.
+    //
+    vector<string> getMinLadder(const string& start, const string& end, WordLadder::SearchWorkspace& state) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns every word exactly one edit away from the given word, in order of length and then
+    // alphabetically, or nothing if it isn't a word.
+    //
+    vector<string> getNeighbors(const string& word) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of words of every length.
+    //
+    int getWordCount() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of seconds it took to build the deletion index, not counting the
+    // partitions built for it.
+    //
+    double getIndexBuildTime() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the statistics of the queries answered with this instance's own workspace.
+    //
+    WordLadder::SearchStatistics getStatistics() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns true if the two strings are exactly one insertion, deletion or substitution apart.
+    //
+    static bool isOneEdit(const char* first, size_t firstLength, const char* second, size_t secondLength);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Checks to see if the given sequence of strings is a valid edit ladder: at least two strings,
+    // with every adjacent pair one edit apart.
+    //
+    static bool isEditLadder(const vector<string>& sequence);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the text WordLadder::formatResult would for the given result, except that the
+    // sequence is checked as an edit ladder rather than as a word ladder.
+    //
+    static string formatResult(const vector<string>& sequence);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Prints formatResult(sequence).
+    //
+    static void displayResult(const vector<string>& sequence);
+
+
+private:
+
+    Lexicon& lexicon;                       // The lexicon whose partitions hold the words
+
+    // The partition of each word length, or null for lengths with no words, and the global ID of
+    // the first word of each length; the words of length l have IDs from firstIds[l] up to (but
+    // not including) firstIds[l + 1].
+    //
+    vector<const WordLadder*> partitions;
+    vector<int> firstIds;
+
+    int wordCount;                          // The number of words of every length
+    int idBits;                             // The low bits of each index entry that hold a word ID
+
+    // The deletion index: an entry for each key of each word, holding the key's hash above the low
+    // idBits bits and the word's global ID in them, sorted.
+    //
+    vector<unsigned long long> deletions;
+
+    // A directory into the deletion index, by the top directoryBits bits of the hash: the entries
+    // whose hashes start with d run from deletionStarts[d] up to deletionStarts[d + 1]. There are
+    // about as many slots as entries, so a lookup goes straight to a handful of entries instead of
+    // binary searching them all.
+    //
+    vector<unsigned int> deletionStarts;
+    int directoryBits;
+
+    WordLadder::SearchWorkspace workspace;  // The workspace reused by the query that doesn't take one
+    double indexBuildTime;                  // How long it took to build the deletion index, in seconds
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the global ID of the given characters, or -1 if they don't spell a word.
+    //
+    int getWordId(const char* text, size_t length) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the length of the word with the given global ID, and stores its characters in text.
+    //
+    int getWord(int id, const char*& text) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the hash of the key left by deleting the letter at the given position of a word, or of
+    // the word itself if position is its length. The ID bits of the hash are clear.
+    //
+    unsigned long long hashKey(const char* word, int length, int position) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Calls visit(neighborId) for every word one edit away from the word with the given global ID.
+    // A neighbor that shares more than one key with the word may be visited more than once. Being a
+    // template, it is defined in EditLadder.cpp, the only file that uses it.
+    //
+    template <typename Visitor>
+    void forEachNeighbor(int id, Visitor visit) const;
+};
@@ -0,0 +1,326 @@
+//==============================================================================================
+// File: HammingKernel.cpp - Vectorized Hamming-distance-one scanning
+// c.f.: HammingKernel.h
+//
+// This file implements the kernel that finds the words of a packed
+// lexicon that are one substitution away from a query. There are three
+// versions -- AVX2, SSE2 and scalar -- and the best one the CPU
+// supports is picked the first time the kernel runs.
+//
+// The vectorized versions treat the whole buffer as one long run of
+// bytes. Since every word has the same length, the byte at offset o
+// belongs at position (o % wordLength) of its word, so comparing the
+// buffer against the query repeated over and over lines every byte up
+// with the query character it should be compared with. We do that 64
+// bytes at a time, collecting one mismatch bit per byte, and then slice
+// each word's bits out of the mask.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "HammingKernel.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HAMMING_KERNEL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// GCC and Clang only let us use AVX2 instructions inside functions that are
+// marked as targeting it; MSVC lets us use them anywhere.
+#if defined(HAMMING_KERNEL_X86) && (defined(__GNUC__) || defined(__clang__))
+#define HAMMING_TARGET_SSE2 __attribute__((target("sse2")))
+#define HAMMING_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HAMMING_TARGET_SSE2
+#define HAMMING_TARGET_AVX2
+#endif
+
+// The number of bytes compared to produce one 64-bit mismatch mask.
+const int BLOCK_SIZE = 64;
+
+namespace
+{
+	typedef unsigned long long BlockMask;
+	typedef BlockMask (*BlockComparer)(const char* block, const char* pattern);
+
+	//------------------------------------------------------------------------------------------
+	// Returns true if exactly one bit of the mask is set.
+	//
+	inline bool hasSingleBit(BlockMask mask)
+	{
+		return mask != 0 && (mask & (mask - 1)) == 0;
+	}
+
+	//------------------------------------------------------------------------------------------
+	// The block comparers each compare 64 bytes of the buffer with 64 bytes of the repeated query,
+	// returning a mask with bit i set if byte i differs.
+	//
+#ifdef HAMMING_KERNEL_X86
+	HAMMING_TARGET_SSE2 BlockMask compareBlockSse2(const char* block, const char* pattern)
+	{
+		BlockMask equal = 0;
+
+		// Each compare covers 16 bytes, and movemask packs the top bit of
+		// each byte of the result -- set where the bytes were equal -- into
+		// 16 bits, so four of them cover the whole block.
+		for (int i = 0; i < 4; i++)
+		{
+			__m128i data = _mm_loadu_si128((const __m128i*)(block + i * 16));
+			__m128i query = _mm_loadu_si128((const __m128i*)(pattern + i * 16));
+
+			equal |= (BlockMask)(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(data, query)) << (i * 16);
+		}
+
+		return ~equal;
+	}
+
+	HAMMING_TARGET_AVX2 BlockMask compareBlockAvx2(const char* block, const char* pattern)
+	{
+		// The same as the SSE2 version, but 32 bytes per compare.
+		__m256i lowData = _mm256_loadu_si256((const __m256i*)block);
+		__m256i lowQuery = _mm256_loadu_si256((const __m256i*)pattern);
+		__m256i highData = _mm256_loadu_si256((const __m256i*)(block + 32));
+		__m256i highQuery = _mm256_loadu_si256((const __m256i*)(pattern + 32));
+
+		BlockMask lowEqual = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lowData, lowQuery));
+		BlockMask highEqual = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(highData, highQuery));
+
+		return ~(lowEqual | highEqual << 32);
+	}
+
+	//------------------------------------------------------------------------------------------
+	// Runs cpuid for the given leaf and subleaf, storing eax, ebx, ecx and edx in registers.
+	//
+	void readCpuid(int leaf, int subleaf, unsigned int registers[4])
+	{
+#if defined(_MSC_VER)
+		int values[4];
+
+		__cpuidex(values, leaf, subleaf);
+
+		for (int i = 0; i < 4; i++)
+		{
+			registers[i] = values[i];
+		}
+#else
+		__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+	}
+
+	//------------------------------------------------------------------------------------------
+	// Returns true if the operating system saves the AVX registers on a context switch, which is
+	// required, along with CPU support, before AVX2 instructions can be used.
+	//
+	bool osSavesAvxState()
+	{
+		unsigned int registers[4];
+
+		readCpuid(1, 0, registers);
+
+		if ((registers[2] & (1u << 27)) == 0) // Without OSXSAVE, we can't even ask.
+		{
+			return false;
+		}
+
+#if defined(_MSC_VER)
+		unsigned long long enabled = _xgetbv(0);
+#else
+		unsigned int eax;
+		unsigned int edx;
+
+		__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+		unsigned long long enabled = ((unsigned long long)edx << 32) | eax;
+#endif
+
+		return (enabled & 0x6) == 0x6; // Both the SSE and AVX register state must be enabled.
+	}
+#endif
+
+	//------------------------------------------------------------------------------------------
+	// The kernel version picked for this CPU, found the first time it is needed.
+	//
+	struct KernelChoice
+	{
+		BlockComparer compareBlock;		// nullptr means the whole scan is done scalar
+		const char* name;
+	};
+
+	KernelChoice chooseKernel()
+	{
+		KernelChoice choice = { nullptr, "scalar" };
+
+#ifdef HAMMING_KERNEL_X86
+		unsigned int registers[4];
+
+		readCpuid(0, 0, registers);
+
+		int highestLeaf = registers[0];
+
+		readCpuid(1, 0, registers);
+
+		if (registers[3] & (1u << 26)) // SSE2 is bit 26 of edx in leaf 1.
+		{
+			choice.compareBlock = compareBlockSse2;
+			choice.name = "sse2";
+		}
+
+		bool hasAvx = (registers[2] & (1u << 28)) != 0;
+
+		if (hasAvx && highestLeaf >= 7 && osSavesAvxState())
+		{
+			readCpuid(7, 0, registers);
+
+			if (registers[1] & (1u << 5)) // AVX2 is bit 5 of ebx in leaf 7.
+			{
+				choice.compareBlock = compareBlockAvx2;
+				choice.name = "avx2";
+			}
+		}
+#endif
+
+		return choice;
+	}
+
+	const KernelChoice& getKernel()
+	{
+		// A function-local static is initialized exactly once, even if
+		// several threads get here at the same time.
+		static const KernelChoice kernel = chooseKernel();
+
+		return kernel;
+	}
+
+	//------------------------------------------------------------------------------------------
+	// The scalar scan, used when the CPU has no vector support or the words are too long for a
+	// word's mismatch bits to fit in one mask.
+	//
+	int findDistanceOneWordsScalar(const char* words, int wordCount, int wordLength, const char* query, int* matches)
+	{
+		int matchCount = 0;
+
+		for (int i = 0; i < wordCount; i++)
+		{
+			if (isDistanceOne(words + (size_t)i * wordLength, query, wordLength))
+			{
+				matches[matchCount++] = i;
+			}
+		}
+
+		return matchCount;
+	}
+}
+
+bool isDistanceOne(const char* first, const char* second, int length)
+{
+	// This method counts the positions where the two strings
+	// differ, but stops as soon as it finds a second one, since
+	// at that point the answer can only be no.
+	//
+	int mismatches = 0;
+
+	for (int i = 0; i < length; i++)
+	{
+		if (first[i] != second[i] && ++mismatches == 2)
+		{
+			return false;
+		}
+	}
+
+	return mismatches == 1;
+}
+
+int findDistanceOneWords(const char* words, int wordCount, int wordLength, const char* query, int* matches)
+{
+	// This method scans the packed buffer block by block. We
+	// keep the masks of the block the current word starts in
+	// and the one after it, since a word can straddle the two,
+	// and slide forward one block whenever the next word starts
+	// past the first.
+	//
+	const KernelChoice& kernel = getKernel();
+
+	if (kernel.compareBlock == nullptr || wordLength <= 0 || wordLength > BLOCK_SIZE || wordCount == 0)
+	{
+		return findDistanceOneWordsScalar(words, wordCount, wordLength, query, matches);
+	}
+
+	// The query repeated enough times that any block, whatever position
+	// in a word it starts at, can be compared against a slice of it.
+	char pattern[2 * BLOCK_SIZE];
+
+	for (int i = 0; i < (int)sizeof(pattern); i++)
+	{
+		pattern[i] = query[i % wordLength];
+	}
+
+	long long totalBytes = (long long)wordCount * wordLength;
+	long long blockCount = (totalBytes + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+	// This compares one block. The last block is usually cut short, so we
+	// copy it into a full-size buffer first; the bytes past the end of the
+	// words never make it into any word's bits, so what they hold doesn't matter.
+	auto compareBlock = [&](long long block) -> BlockMask
+	{
+		long long offset = block * BLOCK_SIZE;
+		const char* blockPattern = pattern + offset % wordLength;
+
+		if (offset + BLOCK_SIZE <= totalBytes)
+		{
+			return kernel.compareBlock(words + offset, blockPattern);
+		}
+
+		char lastBlock[BLOCK_SIZE] = { 0 };
+
+		memcpy(lastBlock, words + offset, (size_t)(totalBytes - offset));
+
+		return kernel.compareBlock(lastBlock, blockPattern);
+	};
+
+	BlockMask wordBits = wordLength == BLOCK_SIZE ? ~(BlockMask)0 : ((BlockMask)1 << wordLength) - 1;
+
+	long long currentBlock = 0;
+	BlockMask currentMask = compareBlock(0);
+	BlockMask nextMask = blockCount > 1 ? compareBlock(1) : 0;
+
+	int matchCount = 0;
+
+	for (int i = 0; i < wordCount; i++)
+	{
+		long long firstBit = (long long)i * wordLength;
+		long long block = firstBit / BLOCK_SIZE;
+		int shift = (int)(firstBit % BLOCK_SIZE);
+
+		while (currentBlock < block) // The word starts in a later block, so we slide forward.
+		{
+			currentBlock++;
+			currentMask = nextMask;
+			nextMask = currentBlock + 1 < blockCount ? compareBlock(currentBlock + 1) : 0;
+		}
+
+		BlockMask bits = currentMask >> shift;
+
+		if (shift + wordLength > BLOCK_SIZE) // The word runs into the next block, so we bring in the rest of its bits.
+		{
+			bits |= nextMask << (BLOCK_SIZE - shift);
+		}
+
+		if (hasSingleBit(bits & wordBits))
+		{
+			matches[matchCount++] = i;
+		}
+	}
+
+	return matchCount;
+}
+
+const char* getHammingKernelName()
+{
+	return getKernel().name;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+//
+// HammingKernel.h Defines the kernel used to scan a packed lexicon for the words that are exactly
+// one substitution away from a query word.
+//
+// The lexicon is a buffer of fixed-width words stored back to back, as in WordLadder. Rather than
+// comparing the query against one word at a time, the kernel compares whole blocks of the buffer
+// against a copy of the query repeated to the same width, 32 or 64 bytes per instruction, and turns
+// the result into one mismatch bit per byte. Each word's bits are then picked out of that mask, and
+// the word is a match exactly when a single one of them is set.
+//
+// The vectorized versions use SSE2 or AVX2, whichever the CPU supports, chosen at runtime the first
+// time the kernel is used. Words longer than 64 characters, and CPUs without SSE2, use a scalar
+// version that compares a word at a time and gives up on it at its second mismatch.
+//
+
+//-------------------------------------------------------------------------------------------------
+// Finds every word in a packed buffer that differs from the query in exactly one position.
+//
+// words        the packed words, wordLength characters each, with no separators
+// wordCount    the number of words in the buffer
+// wordLength   the length of every word, and of the query
+// query        the query word; it does not need to be null-terminated
+// matches      receives the index (within the buffer) of every match, in increasing order; it must
+//              have room for wordCount entries
+// returns      the number of matches written
+//
+int findDistanceOneWords(const char* words, int wordCount, int wordLength, const char* query, int* matches);
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns true if the two strings of the given length differ in exactly one position. Stops
+// comparing at the second mismatch.
+//
+bool isDistanceOne(const char* first, const char* second, int length);
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns the name of the kernel version selected for this CPU: "avx2", "sse2" or "scalar".
+//
+const char* getHammingKernelName();
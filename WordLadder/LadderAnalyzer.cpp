@@ -0,0 +1,370 @@
+//==============================================================================================
+// File: LadderAnalyzer.cpp - Whole-lexicon word ladder analysis implementation
+// c.f.: LadderAnalyzer.h
+//
+// This class runs a breadth-first search from every word of a lexicon,
+// 64 at a time, to find every word's eccentricity, every component's
+// diameter, and the hardest pairs of words, and writes them as JSON.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "LadderAnalyzer.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// The number of start words searched at once, one per bit of a mask.
+const int BATCH_SIZE = 64;
+
+namespace
+{
+	//------------------------------------------------------------------------------------------
+	// Returns the index of the lowest set bit of a non-zero mask.
+	//
+	inline int getLowestBit(uint64_t mask)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+
+		_BitScanForward64(&index, mask);
+
+		return (int)index;
+#elif defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctzll(mask);
+#else
+		int index = 0;
+
+		while ((mask & 1) == 0)
+		{
+			mask >>= 1;
+			index++;
+		}
+
+		return index;
+#endif
+	}
+}
+
+LadderAnalyzer::LadderAnalyzer(const WordLadder& wordLadder, int pairCount, int threadCount) : wordLadder(wordLadder)
+{
+	// The constructor does the whole analysis. The searches are
+	// dealt out a batch at a time from a shared counter, so a
+	// thread stuck with a batch in a big component doesn't hold
+	// the others up. Each thread keeps its own search state and
+	// its own heap of hardest pairs; the eccentricities are
+	// written straight into place, since no two batches share a
+	// start word.
+	//
+	this->pairCount = pairCount < 0 ? 0 : pairCount;
+	wordLength = wordLadder.wordLength;
+	wordComponents = wordLadder.wordComponents;
+	componentSizes = wordLadder.componentSizes;
+
+	int wordCount = wordLadder.getWordCount();
+
+	for (int id = 0; id < wordCount; id++)
+	{
+		words.push_back(wordLadder.getWord(id));
+	}
+
+	eccentricities.assign(wordCount, 0);
+
+	int batchCount = (wordCount + BATCH_SIZE - 1) / BATCH_SIZE;
+
+	if (threadCount <= 0) // Just like BatchSolver, we default to one thread per hardware thread.
+	{
+		threadCount = thread::hardware_concurrency();
+
+		if (threadCount <= 0)
+		{
+			threadCount = 1;
+		}
+	}
+
+	if (threadCount > batchCount) // There's no use for more threads than batches.
+	{
+		threadCount = batchCount > 0 ? batchCount : 1;
+	}
+
+	vector<BatchSearch> searches(threadCount);
+	atomic<int> nextBatch(0);
+
+	auto runSearches = [&](int threadIndex)
+	{
+		BatchSearch& search = searches[threadIndex];
+
+		search.visited.assign(wordCount, 0);
+		search.frontier.assign(wordCount, 0);
+		search.next.assign(wordCount, 0);
+
+		for (int batch = nextBatch++; batch < batchCount; batch = nextBatch++)
+		{
+			searchBatch(batch * BATCH_SIZE, search);
+		}
+	};
+
+	vector<thread> threads;
+
+	for (int i = 1; i < threadCount; i++) // The calling thread is the first of them.
+	{
+		threads.push_back(thread(runSearches, i));
+	}
+
+	runSearches(0);
+
+	for (thread& searchThread : threads)
+	{
+		searchThread.join();
+	}
+
+	// A component's diameter is the largest eccentricity of any
+	// word in it, since a word's searches never leave its component.
+	diameters.assign(componentSizes.size(), 0);
+
+	for (int id = 0; id < wordCount; id++)
+	{
+		diameters[wordComponents[id]] = max(diameters[wordComponents[id]], eccentricities[id]);
+	}
+
+	// Finally, the hardest pairs overall are the hardest of every
+	// thread's hardest pairs.
+	vector<PairCandidate> pairs;
+
+	for (const BatchSearch& search : searches)
+	{
+		for (const PairCandidate& pair : search.pairs)
+		{
+			offerPair(pairs, pair);
+		}
+	}
+
+	sort(pairs.begin(), pairs.end(), isHarder);
+
+	for (const PairCandidate& pair : pairs)
+	{
+		LadderPair hardestPair;
+
+		hardestPair.start = words[pair.start];
+		hardestPair.end = words[pair.end];
+		hardestPair.steps = pair.steps;
+
+		hardestPairs.push_back(hardestPair);
+	}
+}
+
+const vector<int>& LadderAnalyzer::getEccentricities() const
+{
+	return eccentricities;
+}
+
+const vector<int>& LadderAnalyzer::getDiameters() const
+{
+	return diameters;
+}
+
+const vector<LadderAnalyzer::LadderPair>& LadderAnalyzer::getHardestPairs() const
+{
+	return hardestPairs;
+}
+
+void LadderAnalyzer::writeJson(ostream& output) const
+{
+	// The components and pairs come first, since they're what
+	// most readers are after; the eccentricities, one per word,
+	// make up the bulk of the output and come last.
+	//
+	output << "{\n  \"wordLength\": " << wordLength << ",\n  \"wordCount\": " << words.size() << ",\n";
+	output << "  \"components\": [";
+
+	for (unsigned int i = 0; i < diameters.size(); i++)
+	{
+		output << (i == 0 ? "\n" : ",\n") << "    {\"size\": " << componentSizes[i] << ", \"diameter\": " << diameters[i] << "}";
+	}
+
+	output << "\n  ],\n  \"hardestPairs\": [";
+
+	for (unsigned int i = 0; i < hardestPairs.size(); i++)
+	{
+		output << (i == 0 ? "\n" : ",\n") << "    {\"start\": ";
+		writeJsonString(output, hardestPairs[i].start);
+		output << ", \"end\": ";
+		writeJsonString(output, hardestPairs[i].end);
+		output << ", \"steps\": " << hardestPairs[i].steps << "}";
+	}
+
+	output << "\n  ],\n  \"eccentricities\": {";
+
+	for (unsigned int id = 0; id < words.size(); id++)
+	{
+		output << (id == 0 ? "\n    " : ",\n    ");
+		writeJsonString(output, words[id]);
+		output << ": " << eccentricities[id];
+	}
+
+	output << "\n  }\n}";
+}
+
+void LadderAnalyzer::searchBatch(int firstWord, BatchSearch& search)
+{
+	// This method advances up to 64 breadth-first searches at
+	// once. On each level, every word on the frontier passes its
+	// frontier mask along to its neighbors, minus the searches
+	// that have already reached them, which gives the searches
+	// that reach each neighbor on the next level. A word reached
+	// on level L by the search from start word s is exactly L
+	// steps from s, so that's all we need for both the
+	// eccentricities and the pairs.
+	//
+	int batchSize = min(BATCH_SIZE, (int)words.size() - firstWord);
+
+	for (int bit = 0; bit < batchSize; bit++) // Each start word is where its own search begins.
+	{
+		int id = firstWord + bit;
+
+		search.visited[id] = (uint64_t)1 << bit;
+		search.frontier[id] = (uint64_t)1 << bit;
+		search.frontierWords.push_back(id);
+		search.visitedWords.push_back(id);
+	}
+
+	for (int level = 1; !search.frontierWords.empty(); level++)
+	{
+		for (int id : search.frontierWords)
+		{
+			uint64_t mask = search.frontier[id];
+
+			wordLadder.forEachNeighbor(id, [&](int neighbor)
+			{
+				uint64_t reached = mask & ~search.visited[neighbor];
+
+				if (reached != 0)
+				{
+					if (search.next[neighbor] == 0)
+					{
+						search.nextWords.push_back(neighbor);
+					}
+
+					search.next[neighbor] |= reached;
+				}
+			});
+
+			search.frontier[id] = 0;
+		}
+
+		// Only levels at least as deep as the easiest pair kept so
+		// far can hold a harder one, so the shallow levels, which
+		// hold by far the most pairs, are skipped once the heap fills.
+		bool offerPairs = pairCount > 0 && ((int)search.pairs.size() < pairCount || level >= search.pairs.front().steps);
+		uint64_t levelMask = 0;
+
+		for (int id : search.nextWords)
+		{
+			uint64_t mask = search.next[id];
+
+			if (search.visited[id] == 0)
+			{
+				search.visitedWords.push_back(id);
+			}
+
+			search.visited[id] |= mask;
+			search.frontier[id] = mask;
+			search.next[id] = 0;
+			levelMask |= mask;
+
+			while (offerPairs && mask != 0)
+			{
+				PairCandidate pair;
+
+				pair.steps = level;
+				pair.start = firstWord + getLowestBit(mask);
+				pair.end = id;
+
+				if (pair.start < pair.end) // Each pair is found from both ends; we keep one.
+				{
+					offerPair(search.pairs, pair);
+				}
+
+				mask &= mask - 1;
+			}
+		}
+
+		while (levelMask != 0) // Every search that got this far has an eccentricity of at least this level.
+		{
+			eccentricities[firstWord + getLowestBit(levelMask)] = level;
+			levelMask &= levelMask - 1;
+		}
+
+		search.frontierWords.swap(search.nextWords);
+		search.nextWords.clear();
+	}
+
+	// We only clear the words the searches reached, rather than
+	// the whole lexicon, since a batch usually stays within a
+	// small part of it.
+	for (int id : search.visitedWords)
+	{
+		search.visited[id] = 0;
+	}
+
+	search.visitedWords.clear();
+}
+
+void LadderAnalyzer::offerPair(vector<PairCandidate>& pairs, const PairCandidate& pair) const
+{
+	// The heap is ordered so that the easiest pair it holds is on
+	// top, ready to be replaced by anything harder.
+	//
+	if ((int)pairs.size() < pairCount)
+	{
+		pairs.push_back(pair);
+		push_heap(pairs.begin(), pairs.end(), isHarder);
+	}
+	else if (pairCount > 0 && isHarder(pair, pairs.front()))
+	{
+		pop_heap(pairs.begin(), pairs.end(), isHarder);
+		pairs.back() = pair;
+		push_heap(pairs.begin(), pairs.end(), isHarder);
+	}
+}
+
+bool LadderAnalyzer::isHarder(const PairCandidate& a, const PairCandidate& b)
+{
+	if (a.steps != b.steps)
+	{
+		return a.steps > b.steps;
+	}
+
+	return a.start != b.start ? a.start < b.start : a.end < b.end;
+}
+
+void LadderAnalyzer::writeJsonString(ostream& output, const string& str)
+{
+	// Words are normally plain letters, but a dictionary can hold
+	// anything, so we escape whatever JSON requires us to.
+	//
+	const char* hexDigits = "0123456789abcdef";
+
+	output << '"';
+
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			output << '\\' << c;
+		}
+		else if ((unsigned char)c < 0x20)
+		{
+			output << "\\u00" << hexDigits[(c >> 4) & 0xF] << hexDigits[c & 0xF];
+		}
+		else
+		{
+			output << c;
+		}
+	}
+
+	output << '"';
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "WordLadder.h"
+
+//
+// LadderAnalyzer.h Defines an analysis of a whole lexicon's word ladders at once: the eccentricity of
+// every word (the number of steps in the longest minimum ladder starting from it), the diameter of
+// every connected component (the longest minimum ladder inside it), and the hardest pairs of words
+// (the pairs whose minimum ladders are longest), which make the best puzzles.
+//
+// All of these need a breadth-first search from every word, so rather than run them one at a time,
+// the analyzer runs them 64 at a time, as a bit-parallel breadth-first search: every word carries a
+// 64-bit mask of the searches that have reached it, and one pass over the frontier advances all 64
+// searches by a level. Batches of 64 start words are dealt out to one thread per hardware thread.
+//
+// The results can be written out as JSON, for the puzzle generator, or anything else, to read.
+//
+
+using namespace std;
+
+class LadderAnalyzer
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // A pair of words, and the number of steps in the minimum ladder between them.
+    //
+    struct LadderPair
+    {
+        string start;
+        string end;
+        int steps;
+    };
+
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- analyzes every word of the given word ladder's lexicon. The word ladder is only
+    // read while the analyzer is being constructed.
+    //
+    // pairCount    the number of hardest pairs to keep
+    // threadCount  the number of threads to search with; 0 uses one per hardware thread
+    //
+    LadderAnalyzer(const WordLadder& wordLadder, int pairCount = 100, int threadCount = 0);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the eccentricity of every word, by word ID (which is alphabetical order). A word with
+    // no neighbors has an eccentricity of 0.
+    //
+    const vector<int>& getEccentricities() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the diameter of every component, numbered as WordLadder::getComponent numbers them.
+    //
+    const vector<int>& getDiameters() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the hardest pairs, longest ladders first. Each pair is listed once, with its
+    // alphabetically smaller word as the start, and ties are broken alphabetically.
+    //
+    const vector<LadderPair>& getHardestPairs() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Writes the analysis as a single JSON object, holding the word length, the components with
+    // their sizes and diameters, the hardest pairs, and the eccentricity of every word.
+    //
+    void writeJson(ostream& output) const;
+
+
+private:
+
+    // A pair found by a search, by word ID, so that it can be compared and copied cheaply.
+    //
+    struct PairCandidate
+    {
+        int steps;
+        int start;
+        int end;
+    };
+
+    // The state of one thread's bit-parallel search. Bit b of each mask stands for the b-th start
+    // word of the batch being searched.
+    //
+    struct BatchSearch
+    {
+        vector<uint64_t> visited;       // The searches that have reached each word
+        vector<uint64_t> frontier;      // The searches that reached each word on the last level
+        vector<uint64_t> next;          // The searches reaching each word on the level being built
+        vector<int> frontierWords;      // The words with a non-zero frontier mask
+        vector<int> nextWords;          // The words with a non-zero next mask
+        vector<int> visitedWords;       // The words with a non-zero visited mask, to clear them after
+        vector<PairCandidate> pairs;    // This thread's hardest pairs, as a heap with the easiest on top
+    };
+
+    const WordLadder& wordLadder;   // The word ladder being analyzed, during construction only
+    int wordLength;                 // The length of every word
+    int pairCount;                  // The number of hardest pairs to keep
+
+    vector<string> words;           // Every word, by ID
+    vector<int> wordComponents;     // The component of every word
+    vector<int> componentSizes;     // The number of words in every component
+    vector<int> eccentricities;     // The eccentricity of every word
+    vector<int> diameters;          // The diameter of every component
+    vector<LadderPair> hardestPairs;// The hardest pairs, hardest first
+
+
+    //---------------------------------------------------------------------------------------------
+    // Runs the bit-parallel search from the 64 start words beginning at firstWord (or as many as
+    // are left), recording their eccentricities and offering their pairs to the search's heap.
+    //
+    void searchBatch(int firstWord, BatchSearch& search);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Offers a pair to a heap of hardest pairs, which keeps it if it is among the pairCount hardest.
+    //
+    void offerPair(vector<PairCandidate>& pairs, const PairCandidate& pair) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns whether pair a is harder than pair b: it has more steps, or the same steps and comes
+    // first alphabetically.
+    //
+    static bool isHarder(const PairCandidate& a, const PairCandidate& b);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Writes a string as a JSON string literal.
+    //
+    static void writeJsonString(ostream& output, const string& str);
+};
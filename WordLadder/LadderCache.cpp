@@ -0,0 +1,229 @@
+//==============================================================================================
+// File: LadderCache.cpp - Two-level word ladder cache implementation
+// c.f.: LadderCache.h
+//
+// This class caches the answers to word ladder queries, both as whole
+// ladders and as the search trees of popular start words, evicting
+// whatever was used least recently once it runs out of room.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "LadderCache.h"
+
+LadderCache::LadderCache(const WordLadder& wordLadder, size_t ladderBudget, size_t treeBudget, int treeThreshold) : wordLadder(wordLadder)
+{
+	this->ladderBudget = ladderBudget;
+	this->treeBudget = treeBudget;
+	this->treeThreshold = treeThreshold < 1 ? 1 : treeThreshold;
+	generation = wordLadder.getGeneration();
+}
+
+vector<string> LadderCache::getMinLadder(const string& start, const string& end, WordLadder::SearchWorkspace& state)
+{
+	// We try the two levels in order: the ladder itself, then a
+	// search tree for its start word. Only if both miss do we
+	// search, and that happens without the lock held, so that
+	// other threads can keep using the cache in the meantime.
+	//
+	string key = start + " " + end;
+	bool buildTree = false;
+
+	{
+		lock_guard<mutex> guard(cacheLock);
+
+		// Ladders and trees from before the lexicon changed may
+		// use words that are gone, or miss shorter ladders through
+		// new ones, so none of them can be used any more.
+		if (wordLadder.getGeneration() != generation)
+		{
+			clearEntries();
+
+			generation = wordLadder.getGeneration();
+		}
+
+		unordered_map<string, list<LadderEntry>::iterator>::iterator ladderFound = ladderIndex.find(key);
+
+		if (ladderFound != ladderIndex.end()) // The ladder is cached,
+		{
+			ladders.splice(ladders.begin(), ladders, ladderFound->second); // so it is now the most recently used.
+			statistics.ladderHits++;
+
+			return ladderFound->second->ladder;
+		}
+
+		statistics.ladderMisses++;
+
+		unordered_map<string, list<TreeEntry>::iterator>::iterator treeFound = treeIndex.find(start);
+
+		if (treeFound != treeIndex.end()) // The start word's tree is cached,
+		{
+			// so the ladder is only a walk up the tree, which is
+			// cheap enough to do while we still hold the lock.
+			trees.splice(trees.begin(), trees, treeFound->second);
+			statistics.treeHits++;
+
+			vector<string> ladder = wordLadder.getLadderFromTree(treeFound->second->tree, end);
+
+			insertLadder(key, ladder);
+
+			return ladder;
+		}
+
+		statistics.treeMisses++;
+
+		// A start word that keeps missing is popular enough to be
+		// worth a whole search tree.
+		if (treeBudget > 0)
+		{
+			if (startMisses.size() >= MAX_COUNTED_STARTS && startMisses.find(start) == startMisses.end())
+			{
+				startMisses.clear();
+			}
+
+			buildTree = ++startMisses[start] >= treeThreshold;
+
+			if (buildTree)
+			{
+				startMisses.erase(start);
+			}
+		}
+	}
+
+	vector<string> ladder;
+	vector<int> tree;
+
+	if (buildTree)
+	{
+		tree = wordLadder.getSearchTree(start, state);
+		ladder = wordLadder.getLadderFromTree(tree, end);
+	}
+	else
+	{
+		ladder = wordLadder.getMinLadder(start, end, state);
+	}
+
+	lock_guard<mutex> guard(cacheLock);
+
+	if (buildTree)
+	{
+		statistics.treesBuilt++;
+
+		insertTree(start, tree);
+	}
+
+	insertLadder(key, ladder);
+
+	return ladder;
+}
+
+void LadderCache::clear()
+{
+	lock_guard<mutex> guard(cacheLock);
+
+	clearEntries();
+}
+
+void LadderCache::clearEntries()
+{
+	ladders.clear();
+	ladderIndex.clear();
+	trees.clear();
+	treeIndex.clear();
+	startMisses.clear();
+
+	statistics.ladderCount = 0;
+	statistics.treeCount = 0;
+	statistics.ladderBytes = 0;
+	statistics.treeBytes = 0;
+}
+
+LadderCache::Statistics LadderCache::getStatistics() const
+{
+	lock_guard<mutex> guard(cacheLock);
+
+	return statistics;
+}
+
+void LadderCache::insertLadder(const string& key, const vector<string>& ladder)
+{
+	// Another thread may have cached the same ladder while we
+	// were searching, in which case it's already there.
+	//
+	if (ladderIndex.find(key) != ladderIndex.end())
+	{
+		return;
+	}
+
+	size_t bytes = ENTRY_OVERHEAD + 2 * key.size() + ladder.size() * sizeof(string);
+
+	for (const string& word : ladder)
+	{
+		bytes += word.size();
+	}
+
+	if (bytes > ladderBudget) // A ladder bigger than the whole budget is never cached.
+	{
+		return;
+	}
+
+	// We make room by evicting from the back of the list, which
+	// is where the least recently used ladders end up.
+	while (statistics.ladderBytes + bytes > ladderBudget)
+	{
+		statistics.ladderBytes -= ladders.back().bytes;
+		statistics.ladderCount--;
+
+		ladderIndex.erase(ladders.back().key);
+		ladders.pop_back();
+	}
+
+	LadderEntry entry;
+
+	entry.key = key;
+	entry.ladder = ladder;
+	entry.bytes = bytes;
+
+	ladders.push_front(entry);
+	ladderIndex[key] = ladders.begin();
+
+	statistics.ladderBytes += bytes;
+	statistics.ladderCount++;
+}
+
+void LadderCache::insertTree(const string& start, vector<int>& tree)
+{
+	// This works just like insertLadder, except that the tree is
+	// moved into the cache rather than copied, since it's large.
+	//
+	if (treeIndex.find(start) != treeIndex.end())
+	{
+		return;
+	}
+
+	size_t bytes = ENTRY_OVERHEAD + 2 * start.size() + tree.size() * sizeof(int);
+
+	if (bytes > treeBudget)
+	{
+		return;
+	}
+
+	while (statistics.treeBytes + bytes > treeBudget)
+	{
+		statistics.treeBytes -= trees.back().bytes;
+		statistics.treeCount--;
+
+		treeIndex.erase(trees.back().start);
+		trees.pop_back();
+	}
+
+	trees.push_front(TreeEntry());
+
+	trees.front().start = start;
+	trees.front().tree.swap(tree);
+	trees.front().bytes = bytes;
+	treeIndex[start] = trees.begin();
+
+	statistics.treeBytes += bytes;
+	statistics.treeCount++;
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WordLadder.h"
+
+//
+// LadderCache.h Defines a cache in front of WordLadder::getMinLadder, for traffic where the same
+// queries, and the same start words, come up again and again.
+//
+// The cache has two levels. The first holds whole ladders, keyed by their (start, end) pair, so a
+// repeated query costs a single lookup. The second holds complete breadth-first search trees, keyed
+// by their start word (see WordLadder::getSearchTree), so that any query from a cached start word
+// is answered by walking up the tree from its end word, whatever that end word is.
+//
+// A search tree costs a full search to build, and one int per word to keep, so a start word only
+// gets one once it has missed the tree cache treeThreshold times; one-off start words are answered
+// with a plain search instead.
+//
+// Each level has its own memory budget, and evicts its least recently used entries to stay within
+// it. Hits and misses are counted for both levels.
+//
+// The cache is safe to use from several threads at once, as long as each passes its own workspace.
+// No search is run while the cache is locked.
+//
+
+using namespace std;
+
+class LadderCache
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // The cache's counters, and how much it currently holds.
+    //
+    struct Statistics
+    {
+        long long ladderHits = 0;       // Queries answered from the ladder cache
+        long long ladderMisses = 0;     // Queries the ladder cache didn't have
+        long long treeHits = 0;         // Ladder misses answered from a cached search tree
+        long long treeMisses = 0;       // Ladder misses whose start word had no cached search tree
+        long long treesBuilt = 0;       // Search trees built to answer a tree miss
+        int ladderCount = 0;            // The number of ladders cached
+        int treeCount = 0;              // The number of search trees cached
+        size_t ladderBytes = 0;         // The memory used by the cached ladders
+        size_t treeBytes = 0;           // The memory used by the cached search trees
+    };
+
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- the cache answers every query from the given word ladder, which must stay alive
+    // for as long as the cache does. If words are added to it or removed from it (see
+    // WordLadder::addWord), the cache sees its generation change, and empties itself on the next query.
+    //
+    // ladderBudget   the most memory, in bytes, the cached ladders may use
+    // treeBudget     the most memory, in bytes, the cached search trees may use; 0 caches no trees
+    // treeThreshold  how many tree misses a start word must have before its search tree is built
+    //
+    LadderCache(const WordLadder& wordLadder, size_t ladderBudget = 16 << 20, size_t treeBudget = 64 << 20, int treeThreshold = 2);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a minimum-length word ladder from start to end, following the contract of
+    // WordLadder::getMinLadder, from the cache if it can.
+    //
+    // state    the workspace to search with, if the query has to be searched
+    //
+    vector<string> getMinLadder(const string& start, const string& end, WordLadder::SearchWorkspace& state);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Empties both levels of the cache. The counters are kept.
+    //
+    void clear();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the cache's counters, and how much it currently holds.
+    //
+    Statistics getStatistics() const;
+
+
+private:
+
+    // A cached ladder, keyed by its start and end words separated by a space.
+    //
+    struct LadderEntry
+    {
+        string key;
+        vector<string> ladder;
+        size_t bytes;
+    };
+
+    // A cached search tree, keyed by its start word.
+    //
+    struct TreeEntry
+    {
+        string start;
+        vector<int> tree;
+        size_t bytes;
+    };
+
+    // Roughly what each entry costs beyond its contents: the list node, the hash table entry, and
+    // the allocator's own bookkeeping.
+    static const size_t ENTRY_OVERHEAD = 96;
+
+    // The most start words whose tree misses are counted at once. When there are more, the counts
+    // start over, so one-off start words can't grow the counts without bound.
+    static const size_t MAX_COUNTED_STARTS = 4096;
+
+    const WordLadder& wordLadder;   // The word ladder every query is answered from
+    size_t ladderBudget;            // The most memory the cached ladders may use
+    size_t treeBudget;              // The most memory the cached search trees may use
+    int treeThreshold;              // The tree misses a start word needs before its tree is built
+    unsigned long long generation;  // The word ladder's generation when the entries were cached
+
+    // Each level is a list in order of use, most recent first, along with a hash table pointing
+    // into it, so an entry can be found, and moved to the front, in constant time.
+    //
+    list<LadderEntry> ladders;
+    unordered_map<string, list<LadderEntry>::iterator> ladderIndex;
+    list<TreeEntry> trees;
+    unordered_map<string, list<TreeEntry>::iterator> treeIndex;
+
+    unordered_map<string, int> startMisses; // The tree misses of each start word without a tree
+
+    Statistics statistics;          // The counters, along with the current sizes
+    mutable mutex cacheLock;        // Guards everything above
+
+
+    //---------------------------------------------------------------------------------------------
+    // Empties both levels of the cache. Called with cacheLock held.
+    //
+    void clearEntries();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Adds a ladder to the front of the ladder cache, evicting the least recently used ladders
+    // until it fits. Called with cacheLock held.
+    //
+    void insertLadder(const string& key, const vector<string>& ladder);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Adds a search tree to the front of the tree cache, evicting the least recently used trees
+    // until it fits. Called with cacheLock held.
+    //
+    void insertTree(const string& start, vector<int>& tree);
+};
@@ -0,0 +1,335 @@
+//==============================================================================================
+// File: LadderEnumerator.cpp - All-shortest-ladders enumerator implementation
+// c.f.: LadderEnumerator.h
+//
+// This class finds the graph of every minimum-length word ladder between
+// two words with one breadth-first search, counts its paths exactly, and
+// then walks them one at a time.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "LadderEnumerator.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+	// A non-negative integer of any size, as base 2^32 limbs, least
+	// significant first. Path counts only ever need adding, and one
+	// conversion to decimal at the end, so that's all this does.
+	//
+	typedef vector<uint32_t> BigCount;
+
+	void addCount(BigCount& total, const BigCount& amount)
+	{
+		if (total.size() < amount.size())
+		{
+			total.resize(amount.size(), 0);
+		}
+
+		uint64_t carry = 0;
+
+		for (size_t i = 0; i < total.size(); i++)
+		{
+			uint64_t sum = (uint64_t)total[i] + (i < amount.size() ? amount[i] : 0) + carry;
+
+			total[i] = (uint32_t)sum;
+			carry = sum >> 32;
+		}
+
+		if (carry != 0)
+		{
+			total.push_back((uint32_t)carry);
+		}
+	}
+
+	string toDecimal(BigCount count)
+	{
+		// We divide by a billion over and over, and each remainder
+		// gives us the next nine decimal digits, from the right.
+		//
+		string decimal;
+
+		while (!count.empty())
+		{
+			uint64_t remainder = 0;
+
+			for (size_t i = count.size(); i-- > 0;)
+			{
+				uint64_t value = (remainder << 32) | count[i];
+
+				count[i] = (uint32_t)(value / 1000000000);
+				remainder = value % 1000000000;
+			}
+
+			while (!count.empty() && count.back() == 0)
+			{
+				count.pop_back();
+			}
+
+			for (int digit = 0; digit < 9 && (remainder != 0 || !count.empty()); digit++)
+			{
+				decimal += (char)('0' + remainder % 10);
+				remainder /= 10;
+			}
+		}
+
+		if (decimal.empty())
+		{
+			decimal = "0";
+		}
+
+		reverse(decimal.begin(), decimal.end());
+
+		return decimal;
+	}
+}
+
+LadderEnumerator::LadderEnumerator(const WordLadder& wordLadder, const string& start, const string& end)
+{
+	// The constructor builds the DAG of minimum ladders in three
+	// passes: a breadth-first search out from the start word to
+	// find every word's level, a pass back from the end word to
+	// keep only the words on some shortest ladder, and a pass
+	// over what's left to link each level to the next and count
+	// the ladders.
+	//
+	ladderCount = "0";
+	stepCount = -1;
+	started = false;
+	finished = false;
+
+	int startId = wordLadder.getWordId(start);
+	int endId = wordLadder.getWordId(end);
+
+	if (startId == -1 || endId == -1 || startId == endId || wordLadder.wordComponents[startId] != wordLadder.wordComponents[endId])
+	{
+		finished = true;
+
+		return;
+	}
+
+	// The first pass is a breadth-first search that records each
+	// word's level. Once the end word turns up, we only finish the
+	// level before it, since no shortest ladder goes any deeper.
+	vector<int> levels(wordLadder.getWordCount(), -1);
+	vector<int> queue;
+	int endLevel = -1;
+
+	levels[startId] = 0;
+	queue.push_back(startId);
+
+	for (size_t head = 0; head < queue.size(); head++)
+	{
+		int id = queue[head];
+
+		if (endLevel != -1 && levels[id] >= endLevel)
+		{
+			break;
+		}
+
+		wordLadder.forEachNeighbor(id, [&](int neighbor)
+		{
+			if (levels[neighbor] == -1)
+			{
+				levels[neighbor] = levels[id] + 1;
+				queue.push_back(neighbor);
+
+				if (neighbor == endId)
+				{
+					endLevel = levels[neighbor];
+				}
+			}
+		});
+	}
+
+	stepCount = endLevel;
+
+	// The second pass walks the queue backwards, so that every word
+	// is seen after the words a level above it. A word is on a
+	// shortest ladder if it is the end word, or if it leads straight
+	// to a word on a shortest ladder at the next level.
+	vector<bool> onLadder(levels.size(), false);
+
+	onLadder[endId] = true;
+
+	for (size_t i = queue.size(); i-- > 0;)
+	{
+		int id = queue[i];
+
+		if (!onLadder[id] || levels[id] == 0)
+		{
+			continue;
+		}
+
+		wordLadder.forEachNeighbor(id, [&](int neighbor)
+		{
+			if (levels[neighbor] == levels[id] - 1)
+			{
+				onLadder[neighbor] = true;
+			}
+		});
+	}
+
+	// Every word on a ladder becomes a node. Sorting them by level,
+	// then by ID, numbers them the way the header promises, since
+	// word IDs are in alphabetical order.
+	vector<int> nodeIds;
+
+	for (int id : queue)
+	{
+		if (onLadder[id])
+		{
+			nodeIds.push_back(id);
+		}
+	}
+
+	sort(nodeIds.begin(), nodeIds.end(), [&](int a, int b)
+	{
+		return levels[a] != levels[b] ? levels[a] < levels[b] : a < b;
+	});
+
+	vector<int> nodeOf(levels.size(), -1);
+
+	for (int node = 0; node < (int)nodeIds.size(); node++)
+	{
+		nodeOf[nodeIds[node]] = node;
+		words.push_back(wordLadder.getWord(nodeIds[node]));
+	}
+
+	// The third pass links each node to its children on the next
+	// level. Each node's children come out sorted once we sort its
+	// own list, since node numbers follow IDs within a level.
+	for (int node = 0; node < (int)nodeIds.size(); node++)
+	{
+		int id = nodeIds[node];
+
+		childOffsets.push_back(children.size());
+
+		wordLadder.forEachNeighbor(id, [&](int neighbor)
+		{
+			if (nodeOf[neighbor] != -1 && levels[neighbor] == levels[id] + 1)
+			{
+				children.push_back(nodeOf[neighbor]);
+			}
+		});
+
+		sort(children.begin() + childOffsets.back(), children.end());
+	}
+
+	childOffsets.push_back(children.size());
+
+	// Finally we count the ladders. The number of ladders from a node
+	// to the end word is the sum of the numbers from its children, so
+	// working from the last node back to the first, each node's count
+	// is ready by the time any of its parents need it.
+	vector<BigCount> pathCounts(words.size());
+
+	pathCounts.back() = BigCount(1, 1); // The end word has the single, empty path to itself.
+
+	for (int node = (int)words.size() - 2; node >= 0; node--)
+	{
+		for (int child = childOffsets[node]; child < childOffsets[node + 1]; child++)
+		{
+			addCount(pathCounts[node], pathCounts[children[child]]);
+		}
+	}
+
+	ladderCount = toDecimal(pathCounts[0]);
+}
+
+bool LadderEnumerator::next(vector<string>& ladder)
+{
+	// Each call moves on to the next path through the DAG, the way a
+	// depth-first search would. The first path takes the first child
+	// all the way down; each one after backs up to the deepest node
+	// with a child it hasn't tried yet, tries it, and takes the first
+	// child all the way down from there. Every node leads to the end
+	// word, so there are no dead ends to back out of.
+	//
+	if (finished)
+	{
+		return false;
+	}
+
+	if (!started)
+	{
+		started = true;
+
+		pathNodes.assign(1, 0);
+		pathChoices.clear();
+		descend();
+	}
+	else
+	{
+		bool advanced = false;
+
+		while (!pathChoices.empty() && !advanced) // We back up one node at a time,
+		{
+			int choice = pathChoices.back() + 1;
+
+			pathChoices.pop_back();
+			pathNodes.pop_back();
+
+			int parent = pathNodes.back();
+
+			if (childOffsets[parent] + choice < childOffsets[parent + 1]) // until a node has another child to try.
+			{
+				pathChoices.push_back(choice);
+				pathNodes.push_back(children[childOffsets[parent] + choice]);
+				descend();
+
+				advanced = true;
+			}
+		}
+
+		if (!advanced) // We backed up all the way to the start word, so every ladder has been produced.
+		{
+			finished = true;
+
+			return false;
+		}
+	}
+
+	ladder.clear();
+
+	for (int node : pathNodes)
+	{
+		ladder.push_back(words[node]);
+	}
+
+	return true;
+}
+
+void LadderEnumerator::reset()
+{
+	started = false;
+	finished = words.empty();
+}
+
+string LadderEnumerator::getLadderCount() const
+{
+	return ladderCount;
+}
+
+int LadderEnumerator::getStepCount() const
+{
+	return stepCount;
+}
+
+int LadderEnumerator::getWordCount() const
+{
+	return words.size();
+}
+
+void LadderEnumerator::descend()
+{
+	// The last node is the end word, and the only node without children.
+	//
+	while (pathNodes.back() != (int)words.size() - 1)
+	{
+		pathChoices.push_back(0);
+		pathNodes.push_back(children[childOffsets[pathNodes.back()]]);
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "WordLadder.h"
+
+//
+// LadderEnumerator.h Defines an enumerator over every minimum-length word ladder between two words,
+// rather than the single, unspecified one WordLadder::getMinLadder returns.
+//
+// The constructor runs one breadth-first search from the start word, through the level holding the
+// end word, and keeps only the words that lie on some shortest ladder, along with the edges between
+// consecutive levels. Every path through that directed acyclic graph (DAG) from start to end is a
+// minimum ladder, and every minimum ladder is such a path.
+//
+// The number of ladders can grow exponentially with their length, so they are never all built at
+// once. The count is worked out exactly, by adding up the paths through each word of the DAG, and
+// held as an arbitrary-precision integer. The ladders themselves are produced one at a time by next,
+// in alphabetical order, with a depth-first walk of the DAG that only keeps the current ladder.
+//
+// The enumerator only reads the WordLadder while it is being constructed, and copies the words of
+// the DAG out of it, so the WordLadder is free to go away afterwards.
+//
+
+using namespace std;
+
+class LadderEnumerator
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- finds every minimum-length word ladder from start to end in the given word
+    // ladder's lexicon. As with getMinLadder, there are none if either word isn't a word, or if
+    // start and end are the same word.
+    //
+    LadderEnumerator(const WordLadder& wordLadder, const string& start, const string& end);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Moves on to the next minimum ladder, in alphabetical order.
+    //
+    // ladder   set to the next ladder, from start to end
+    // returns  true if there was another ladder, false once every ladder has been produced
+    //
+    bool next(vector<string>& ladder);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Starts the enumeration over, so that next produces the first ladder again.
+    //
+    void reset();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the exact number of minimum ladders, in decimal. It is "0" if there are none.
+    //
+    string getLadderCount() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of steps in every minimum ladder, or -1 if there are none.
+    //
+    int getStepCount() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of words that lie on at least one minimum ladder, start and end included.
+    //
+    int getWordCount() const;
+
+
+private:
+
+    // The DAG of minimum ladders. Its nodes are numbered in order of their level, then alphabetically
+    // within a level, so node 0 is the start word and the last node is the end word. The nodes one
+    // step further along from node n are children[childOffsets[n]] up to (but not including)
+    // children[childOffsets[n + 1]], in alphabetical order.
+    //
+    vector<string> words;           // The word of every node
+    vector<int> childOffsets;       // Where each node's children start in children
+    vector<int> children;           // Every node's children, back to back
+
+    string ladderCount;             // The number of minimum ladders, in decimal
+    int stepCount;                  // The number of steps in every minimum ladder
+
+    // The ladder the enumeration is on, as the nodes along it, along with which of its children each
+    // node's successor on the ladder is, as an index into its child list.
+    //
+    vector<int> pathNodes;
+    vector<int> pathChoices;
+    bool started;                   // Whether next has produced a ladder yet
+    bool finished;                  // Whether every ladder has been produced
+
+
+    //---------------------------------------------------------------------------------------------
+    // Extends the current path to the end word by always taking the first child.
+    //
+    void descend();
+};
@@ -0,0 +1,615 @@
+//==============================================================================================
+// File: LadderServer.cpp - Word ladder server implementation
+// c.f.: LadderServer.h
+//
+// This class answers word ladder queries sent over local sockets. All
+// of its clients are handled on one thread: every socket is non-blocking,
+// and a single call to poll tells us which of them can be read from or
+// written to, so no client can hold up the others by being slow.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "LadderServer.h"
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+	typedef WSAPOLLFD PollEntry;
+
+	const uintptr_t NO_SOCKET = INVALID_SOCKET;
+
+	int pollSockets(PollEntry* entries, size_t count, int timeout)
+	{
+		return WSAPoll(entries, (ULONG)count, timeout);
+	}
+
+	bool wouldBlock()
+	{
+		return WSAGetLastError() == WSAEWOULDBLOCK;
+	}
+
+	bool wasInterrupted()
+	{
+		return WSAGetLastError() == WSAEINTR;
+	}
+#else
+	typedef pollfd PollEntry;
+
+	const int NO_SOCKET = -1;
+
+	int pollSockets(PollEntry* entries, size_t count, int timeout)
+	{
+		return poll(entries, (nfds_t)count, timeout);
+	}
+
+	bool wouldBlock()
+	{
+		return errno == EAGAIN || errno == EWOULDBLOCK;
+	}
+
+	bool wasInterrupted()
+	{
+		return errno == EINTR;
+	}
+#endif
+
+#ifdef MSG_NOSIGNAL
+	const int SEND_FLAGS = MSG_NOSIGNAL; // A client that hangs up shouldn't kill the server with SIGPIPE.
+#else
+	const int SEND_FLAGS = 0;
+#endif
+}
+
+LadderServer::LadderServer(Lexicon& lexicon) : lexicon(lexicon)
+{
+	stopping = false;
+	socketsStarted = true;
+
+#ifdef _WIN32
+	// Winsock has to be started before any socket is created.
+	WSADATA socketData;
+
+	socketsStarted = WSAStartup(MAKEWORD(2, 2), &socketData) == 0;
+#endif
+}
+
+LadderServer::~LadderServer()
+{
+	for (const pair<const int, LadderCache*>& cache : caches)
+	{
+		delete cache.second;
+	}
+
+	for (Connection* connection : connections)
+	{
+		closeSocket(connection->socket);
+
+		delete connection;
+	}
+
+	for (SocketHandle listener : listeners)
+	{
+		closeSocket(listener);
+	}
+
+#ifndef _WIN32
+	if (!unixSocketPath.empty())
+	{
+		unlink(unixSocketPath.c_str()); // The socket file would otherwise outlive the server.
+	}
+#endif
+
+#ifdef _WIN32
+	if (socketsStarted)
+	{
+		WSACleanup();
+	}
+#endif
+}
+
+bool LadderServer::listenTcp(int port)
+{
+	// We only ever bind to the loopback address, so the
+	// server can't be reached from any other machine.
+	//
+	if (!socketsStarted)
+	{
+		return false;
+	}
+
+	SocketHandle listener = socket(AF_INET, SOCK_STREAM, 0);
+
+	if (listener == NO_SOCKET)
+	{
+		return false;
+	}
+
+#ifndef _WIN32
+	// This lets a restarted server bind the port straight away,
+	// instead of waiting out the last one's closed connections.
+	int reuse = 1;
+
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+#endif
+
+	sockaddr_in address;
+
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons((unsigned short)port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if (bind(listener, (const sockaddr*)&address, sizeof(address)) != 0 || !startListening(listener))
+	{
+		closeSocket(listener);
+
+		return false;
+	}
+
+	listeners.push_back(listener);
+
+	return true;
+}
+
+bool LadderServer::listenUnix(const string& path)
+{
+#ifdef _WIN32
+	(void)path;
+
+	return false; // Only TCP is supported on Windows.
+#else
+	sockaddr_un address;
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+
+	if (path.empty() || path.length() >= sizeof(address.sun_path))
+	{
+		return false; // The path has to fit in the address, null character and all.
+	}
+
+	memcpy(address.sun_path, path.c_str(), path.length() + 1);
+
+	SocketHandle listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (listener == NO_SOCKET)
+	{
+		return false;
+	}
+
+	// A socket file left behind by a server that didn't shut down
+	// cleanly would stop us from binding, so we remove it first.
+	unlink(path.c_str());
+
+	if (bind(listener, (const sockaddr*)&address, sizeof(address)) != 0 || !startListening(listener))
+	{
+		closeSocket(listener);
+
+		return false;
+	}
+
+	listeners.push_back(listener);
+	unixSocketPath = path;
+
+	return true;
+#endif
+}
+
+void LadderServer::stop()
+{
+	stopping = true;
+}
+
+LadderCache::Statistics LadderServer::getCacheStatistics() const
+{
+	LadderCache::Statistics total;
+
+	for (const pair<const int, LadderCache*>& cache : caches)
+	{
+		LadderCache::Statistics statistics = cache.second->getStatistics();
+
+		total.ladderHits += statistics.ladderHits;
+		total.ladderMisses += statistics.ladderMisses;
+		total.treeHits += statistics.treeHits;
+		total.treeMisses += statistics.treeMisses;
+		total.treesBuilt += statistics.treesBuilt;
+		total.ladderCount += statistics.ladderCount;
+		total.treeCount += statistics.treeCount;
+		total.ladderBytes += statistics.ladderBytes;
+		total.treeBytes += statistics.treeBytes;
+	}
+
+	return total;
+}
+
+WordLadder::SearchStatistics LadderServer::getSearchStatistics() const
+{
+	return workspace.statistics;
+}
+
+LatencyHistogram LadderServer::getLatencies() const
+{
+	return latencies;
+}
+
+void LadderServer::run()
+{
+	// This is the event loop. Each time around, we poll every
+	// socket at once: the listeners for new clients, and each
+	// client for requests to read or, if it has responses
+	// waiting, for room to send them. Then we deal with
+	// whichever sockets are ready, and go around again.
+	//
+	vector<PollEntry> entries;
+
+	while (!stopping && !listeners.empty())
+	{
+		entries.clear();
+
+		for (SocketHandle listener : listeners)
+		{
+			PollEntry entry;
+
+			entry.fd = listener;
+			entry.events = POLLIN;
+			entry.revents = 0;
+
+			entries.push_back(entry);
+		}
+
+		for (Connection* connection : connections)
+		{
+			PollEntry entry;
+			bool outputPending = connection->outputSent < connection->output.size();
+
+			entry.fd = connection->socket;
+			entry.events = 0;
+			entry.revents = 0;
+
+			// A client whose responses are backing up has to read
+			// them before we take any more of its requests.
+			if (!connection->inputClosed && connection->output.size() - connection->outputSent < MAX_PENDING_OUTPUT)
+			{
+				entry.events |= POLLIN;
+			}
+
+			if (outputPending)
+			{
+				entry.events |= POLLOUT;
+			}
+
+			entries.push_back(entry);
+		}
+
+		int readyCount = pollSockets(entries.data(), entries.size(), POLL_INTERVAL);
+
+		if (readyCount <= 0)
+		{
+			continue; // Either nothing happened in time, or we were interrupted; we check stopping either way.
+		}
+
+		// The connections are handled first, before new clients are
+		// accepted, so that the entries still line up with them.
+		size_t listenerCount = listeners.size();
+		vector<Connection*> openConnections;
+
+		for (size_t i = 0; i < connections.size(); i++)
+		{
+			Connection* connection = connections[i];
+			short events = entries[listenerCount + i].revents;
+			bool open = true;
+
+			if (events & (POLLIN | POLLHUP | POLLERR))
+			{
+				open = readRequests(connection);
+			}
+
+			// We answer and send until either the client's socket is
+			// full, in which case poll tells us when it has room, or
+			// there are no whole requests left, in which case poll
+			// tells us when more arrive.
+			while (open)
+			{
+				open = answerRequests(connection);
+
+				if (open && connection->outputSent < connection->output.size())
+				{
+					open = writeResponses(connection);
+				}
+
+				if (connection->outputSent < connection->output.size() || connection->input.find('\n') == string::npos)
+				{
+					break;
+				}
+			}
+
+			// Once the client has finished sending and has been sent
+			// every response, there is nothing left to do for it.
+			if (open && connection->inputClosed && connection->input.empty() && connection->outputSent == connection->output.size())
+			{
+				open = false;
+			}
+
+			if (open)
+			{
+				openConnections.push_back(connection);
+			}
+			else
+			{
+				closeSocket(connection->socket);
+
+				delete connection;
+			}
+		}
+
+		connections.swap(openConnections);
+
+		for (size_t i = 0; i < listenerCount; i++)
+		{
+			if (entries[i].revents & POLLIN)
+			{
+				acceptConnections(listeners[i]);
+			}
+		}
+	}
+}
+
+bool LadderServer::startListening(SocketHandle socket)
+{
+	// Every socket the event loop touches has to be non-blocking,
+	// so that a call on a socket that isn't ready returns straight
+	// away, rather than stopping the whole server.
+	//
+#ifdef _WIN32
+	u_long nonBlocking = 1;
+
+	if (ioctlsocket(socket, FIONBIO, &nonBlocking) != 0)
+	{
+		return false;
+	}
+#else
+	int flags = fcntl(socket, F_GETFL, 0);
+
+	if (flags < 0 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) != 0)
+	{
+		return false;
+	}
+#endif
+
+	return listen(socket, SOMAXCONN) == 0;
+}
+
+void LadderServer::acceptConnections(SocketHandle listener)
+{
+	// Several clients may have connected since we last looked,
+	// so we keep accepting until there are none left waiting.
+	//
+	while (true)
+	{
+		SocketHandle client = accept(listener, nullptr, nullptr);
+
+		if (client == NO_SOCKET)
+		{
+			return;
+		}
+
+#ifdef _WIN32
+		u_long nonBlocking = 1;
+		bool ready = ioctlsocket(client, FIONBIO, &nonBlocking) == 0;
+#else
+		int flags = fcntl(client, F_GETFL, 0);
+		bool ready = flags >= 0 && fcntl(client, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+
+		if (!ready)
+		{
+			closeSocket(client);
+
+			continue;
+		}
+
+		Connection* connection = new Connection();
+
+		connection->socket = client;
+		connection->outputSent = 0;
+		connection->inputClosed = false;
+
+		connections.push_back(connection);
+	}
+}
+
+bool LadderServer::readRequests(Connection* connection)
+{
+	// We read everything the client has sent so far onto the end
+	// of its input. Requests are only answered once their whole
+	// line has arrived, which answerRequests takes care of.
+	//
+	char buffer[16384];
+
+	while (!connection->inputClosed)
+	{
+		int received = recv(connection->socket, buffer, sizeof(buffer), 0);
+
+		if (received > 0)
+		{
+			connection->input.append(buffer, received);
+
+			if (connection->output.size() - connection->outputSent >= MAX_PENDING_OUTPUT)
+			{
+				return true; // We read no more until the client catches up with its responses.
+			}
+
+			continue;
+		}
+
+		if (received == 0) // The client has finished sending,
+		{
+			// so any last request without a newline is still a request.
+			if (!connection->input.empty() && connection->input.back() != '\n')
+			{
+				connection->input += '\n';
+			}
+
+			connection->inputClosed = true;
+
+			return true;
+		}
+
+		if (wasInterrupted())
+		{
+			continue;
+		}
+
+		return wouldBlock(); // Having nothing more to read is fine; anything else is a failed connection.
+	}
+
+	return true;
+}
+
+bool LadderServer::answerRequests(Connection* connection)
+{
+	// This method answers each complete line in the client's
+	// input, in order, appending the responses to its output.
+	// The line is consumed once it has been answered.
+	//
+	size_t lineStart = 0;
+
+	while (connection->output.size() - connection->outputSent < MAX_PENDING_OUTPUT)
+	{
+		size_t lineEnd = connection->input.find('\n', lineStart);
+
+		if (lineEnd == string::npos)
+		{
+			break;
+		}
+
+		LADDER_STATS(chrono::steady_clock::time_point requestStart = chrono::steady_clock::now());
+
+		connection->output += answerRequest(connection->input.substr(lineStart, lineEnd - lineStart));
+
+		LADDER_STATS(chrono::duration<double> requestDuration = chrono::steady_clock::now() - requestStart);
+		LADDER_STATS(latencies.record(requestDuration.count()));
+
+		lineStart = lineEnd + 1;
+	}
+
+	connection->input.erase(0, lineStart);
+
+	// Whatever is left is part of a line. If it's already too long,
+	// the client isn't speaking our protocol, so we hang up on it.
+	return connection->input.size() <= MAX_LINE_LENGTH || connection->input.find('\n') != string::npos;
+}
+
+bool LadderServer::writeResponses(Connection* connection)
+{
+	// We send as much of the client's output as the socket will
+	// take. Once all of it has been sent, the buffer is cleared,
+	// so that it doesn't keep growing for as long as the client
+	// stays connected.
+	//
+	while (connection->outputSent < connection->output.size())
+	{
+		size_t remaining = connection->output.size() - connection->outputSent;
+		int sent = send(connection->socket, connection->output.data() + connection->outputSent, (int)(remaining < 65536 ? remaining : 65536), SEND_FLAGS);
+
+		if (sent > 0)
+		{
+			connection->outputSent += sent;
+
+			continue;
+		}
+
+		if (sent < 0 && wasInterrupted())
+		{
+			continue;
+		}
+
+		if (sent < 0 && wouldBlock())
+		{
+			break; // The socket is full, so we wait until poll says there's room again.
+		}
+
+		return false;
+	}
+
+	if (connection->outputSent == connection->output.size())
+	{
+		connection->output.clear();
+		connection->outputSent = 0;
+	}
+
+	return true;
+}
+
+string LadderServer::answerRequest(const string& line)
+{
+	// This method answers a single request, with exactly the
+	// text the command line program would have printed for it.
+	//
+	istringstream request(line);
+	string firstWord;
+	string lastWord;
+	string extra;
+
+	if (!(request >> firstWord >> lastWord) || (request >> extra))
+	{
+		return "Expected a request of the form: first_word last_word\n";
+	}
+
+	// The dictionary is all uppercase, so the words must be too.
+	for (char& c : firstWord)
+	{
+		c = (char)toupper((unsigned char)c);
+	}
+
+	for (char& c : lastWord)
+	{
+		c = (char)toupper((unsigned char)c);
+	}
+
+	if (firstWord.length() != lastWord.length())
+	{
+		return "The first and final word do not have the same length.\n";
+	}
+
+	WordLadder& wordLadder = lexicon.getWordLadder(firstWord.length());
+	LadderCache*& cache = caches[firstWord.length()];
+
+	if (cache == nullptr) // The first query of each length sets up its cache.
+	{
+		cache = new LadderCache(wordLadder);
+	}
+
+	return wordLadder.formatResult(cache->getMinLadder(firstWord, lastWord, workspace));
+}
+
+void LadderServer::closeSocket(SocketHandle socket)
+{
+#ifdef _WIN32
+	closesocket(socket);
+#else
+	close(socket);
+#endif
+}
@@ -0,0 +1,187 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "LadderCache.h"
+#include "LatencyHistogram.h"
+#include "Lexicon.h"
+#include "WordLadder.h"
+
+//
+// LadderServer.h Defines a server that answers word ladder queries over local sockets, so that the
+// lexicon is loaded once for the life of the server instead of once per query.
+//
+// Clients send requests as lines of text, each holding a start word and an end word separated by
+// whitespace, and get back one response per request, in the same order, formatted exactly as
+// WordLadder::displayResult prints it. A client may send any number of requests without waiting for
+// the responses (pipelining); they are answered as soon as each line arrives. A line that isn't two
+// words gets a one-line error in place of a ladder.
+//
+// The server listens on a TCP port bound to localhost (127.0.0.1), on a Unix domain socket, or both,
+// and handles every client from a single thread, with non-blocking sockets and poll (WSAPoll on
+// Windows). Unix domain sockets are not supported on Windows.
+//
+// Every query goes through a LadderCache for its word length, so repeated queries, and queries from
+// popular start words, are answered without searching.
+//
+// Unless WORD_LADDER_STATS compiled them out, the server also keeps a histogram of how long each
+// request took to answer, cache hits included, along with the statistics of the searches it ran.
+//
+// For example, with the server listening on port 5000, "echo 'cold warm' | nc localhost 5000" prints
+// the ladder between COLD and WARM.
+//
+
+using namespace std;
+
+class LadderServer
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- the server answers every query from the given lexicon, which must stay alive
+    // for as long as the server does
+    //
+    LadderServer(Lexicon& lexicon);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Destructor -- closes every connection and listening socket, and removes the Unix socket file
+    //
+    ~LadderServer();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Starts listening on the given TCP port of the loopback interface.
+    //
+    // port     the port to listen on
+    // returns  true if the server is listening, false if the port could not be bound
+    //
+    bool listenTcp(int port);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Starts listening on a Unix domain socket at the given path, replacing any file already there.
+    //
+    // path     the path of the socket file
+    // returns  true if the server is listening, false if the socket could not be created
+    //
+    bool listenUnix(const string& path);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Answers clients until stop is called. Returns straight away if the server isn't listening.
+    //
+    void run();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Asks run to return. Safe to call from another thread, or from a signal handler.
+    //
+    void stop();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the counters of every word length's cache, added together.
+    //
+    LadderCache::Statistics getCacheStatistics() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the statistics of every search the server has run. Queries answered from a cache
+    // didn't search, so they aren't counted.
+    //
+    WordLadder::SearchStatistics getSearchStatistics() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the time taken to answer each request so far. Must not be called while run is running.
+    //
+    LatencyHistogram getLatencies() const;
+
+
+private:
+
+#ifdef _WIN32
+    typedef uintptr_t SocketHandle;     // A Winsock SOCKET
+#else
+    typedef int SocketHandle;           // A file descriptor
+#endif
+
+    // A connected client. Its requests build up in input until a whole line has arrived, and its
+    // responses wait in output until the socket can take them.
+    //
+    struct Connection
+    {
+        SocketHandle socket;
+        string input;                   // Bytes received but not yet answered
+        string output;                  // Responses not yet sent
+        size_t outputSent;              // How much of output has been sent already
+        bool inputClosed;               // Whether the client has finished sending
+    };
+
+    // The longest request line we accept; a client sending more without a newline is disconnected.
+    static const size_t MAX_LINE_LENGTH = 4096;
+
+    // How many bytes of responses may wait for a client before we stop reading its requests.
+    static const size_t MAX_PENDING_OUTPUT = 1 << 20;
+
+    // How often, in milliseconds, the event loop wakes up to check whether it has been stopped.
+    static const int POLL_INTERVAL = 200;
+
+    Lexicon& lexicon;                       // The lexicon every query is answered from
+    WordLadder::SearchWorkspace workspace;  // The workspace for every search, since they all run on one thread
+    map<int, LadderCache*> caches;          // The cache in front of each word length's partition
+    LatencyHistogram latencies;             // The time taken to answer each request
+    vector<SocketHandle> listeners;         // The sockets accepting new clients
+    vector<Connection*> connections;        // Every connected client
+    string unixSocketPath;                  // The path of the Unix socket, to remove it when we close
+    bool socketsStarted;                    // Whether the socket library is initialized (Winsock only)
+    atomic<bool> stopping;                  // Set by stop
+
+
+    //---------------------------------------------------------------------------------------------
+    // Makes the given socket non-blocking and starts listening on it.
+    //
+    bool startListening(SocketHandle socket);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Accepts every client waiting on the given listening socket.
+    //
+    void acceptConnections(SocketHandle listener);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Reads whatever the client has sent. Returns false if the connection failed.
+    //
+    bool readRequests(Connection* connection);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Answers every complete request line the client has sent, as long as its output isn't backed up.
+    // Returns false if the client sent a line that is too long.
+    //
+    bool answerRequests(Connection* connection);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Sends as much of the client's pending output as the socket will take. Returns false if the
+    // connection failed.
+    //
+    bool writeResponses(Connection* connection);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the response to a single request line.
+    //
+    string answerRequest(const string& line);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Closes the given socket.
+    //
+    static void closeSocket(SocketHandle socket);
+};
@@ -0,0 +1,196 @@
+//==============================================================================================
+// File: LatencyHistogram.cpp - Latency histogram implementation
+// c.f.: LatencyHistogram.h
+//
+// This class counts query latencies in log-linear buckets, so that
+// percentiles of any number of queries can be reported from a small,
+// fixed amount of memory.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "LatencyHistogram.h"
+#include <cmath>
+#include <cstdio>
+
+LatencyHistogram::LatencyHistogram()
+{
+	// The first SUB_BUCKETS buckets hold a single nanosecond count
+	// each, and every power of two from there on gets SUB_BUCKETS more.
+	//
+	counts.assign((MAGNITUDES - 2) * SUB_BUCKETS, 0);
+	count = 0;
+	totalSeconds = 0;
+	maximumSeconds = 0;
+}
+
+void LatencyHistogram::record(double seconds, long long times)
+{
+	if (seconds < 0) // A clock can't really go backwards, but we don't trust it not to.
+	{
+		seconds = 0;
+	}
+
+	counts[getBucket((uint64_t)(seconds * 1e9))] += times;
+	count += times;
+	totalSeconds += seconds * times;
+
+	if (seconds > maximumSeconds)
+	{
+		maximumSeconds = seconds;
+	}
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+	for (unsigned int i = 0; i < counts.size(); i++)
+	{
+		counts[i] += other.counts[i];
+	}
+
+	count += other.count;
+	totalSeconds += other.totalSeconds;
+
+	if (other.maximumSeconds > maximumSeconds)
+	{
+		maximumSeconds = other.maximumSeconds;
+	}
+}
+
+long long LatencyHistogram::getCount() const
+{
+	return count;
+}
+
+double LatencyHistogram::getPercentile(double percentile) const
+{
+	// We find the rank of the latency we want, counting from one,
+	// then walk the buckets until we've passed that many latencies.
+	// The bucket we stop in holds it, so its limit is an upper bound
+	// on it, which we tighten to the maximum in the last bucket.
+	//
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	long long rank = (long long)ceil(percentile / 100 * count);
+
+	if (rank < 1)
+	{
+		rank = 1;
+	}
+	else if (rank > count)
+	{
+		rank = count;
+	}
+
+	long long seen = 0;
+
+	for (unsigned int bucket = 0; bucket < counts.size(); bucket++)
+	{
+		seen += counts[bucket];
+
+		if (seen >= rank)
+		{
+			double limit = getBucketLimit(bucket) * 1e-9;
+
+			return limit < maximumSeconds ? limit : maximumSeconds;
+		}
+	}
+
+	return maximumSeconds;
+}
+
+double LatencyHistogram::getMaximum() const
+{
+	return maximumSeconds;
+}
+
+double LatencyHistogram::getMean() const
+{
+	return count == 0 ? 0 : totalSeconds / count;
+}
+
+string LatencyHistogram::format() const
+{
+	return "p50 " + formatSeconds(getPercentile(50)) + ", p99 " + formatSeconds(getPercentile(99)) +
+		", max " + formatSeconds(maximumSeconds) + ", mean " + formatSeconds(getMean()) + " over " + to_string(count) + " queries";
+}
+
+int LatencyHistogram::getBucket(uint64_t nanoseconds)
+{
+	// Below SUB_BUCKETS nanoseconds, every count has a bucket of
+	// its own. Above that, we find the highest set bit, and the
+	// three bits below it (for eight sub-buckets) pick the bucket
+	// within that power of two.
+	//
+	if (nanoseconds < SUB_BUCKETS)
+	{
+		return (int)nanoseconds;
+	}
+
+	int magnitude = 0;
+
+	while ((nanoseconds >> (magnitude + 1)) != 0)
+	{
+		magnitude++;
+	}
+
+	if (magnitude >= MAGNITUDES) // Anything past the last power of two goes in the last bucket.
+	{
+		return (MAGNITUDES - 2) * SUB_BUCKETS - 1;
+	}
+
+	int shift = magnitude - 3; // SUB_BUCKETS is 2^3
+
+	return (magnitude - 2) * SUB_BUCKETS + (int)((nanoseconds >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t LatencyHistogram::getBucketLimit(int bucket)
+{
+	// This undoes getBucket: the bucket gives us the highest bit
+	// and the three bits below it, and the limit has every bit
+	// below those set.
+	//
+	if (bucket < SUB_BUCKETS)
+	{
+		return bucket;
+	}
+
+	int shift = bucket / SUB_BUCKETS - 1;
+	uint64_t lower = (uint64_t)(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+
+	return lower + ((uint64_t)1 << shift) - 1;
+}
+
+string LatencyHistogram::formatSeconds(double seconds)
+{
+	// We pick the largest unit the time is at least one of, and
+	// keep three significant digits.
+	//
+	const char* unit = "s";
+	double value = seconds;
+
+	if (seconds < 1e-6)
+	{
+		unit = "ns";
+		value = seconds * 1e9;
+	}
+	else if (seconds < 1e-3)
+	{
+		unit = "us";
+		value = seconds * 1e6;
+	}
+	else if (seconds < 1)
+	{
+		unit = "ms";
+		value = seconds * 1e3;
+	}
+
+	char text[32];
+
+	snprintf(text, sizeof(text), "%.3g %s", value, unit);
+
+	return text;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// LatencyHistogram.h Defines a histogram of query latencies, for reporting percentiles like the
+// median (p50) and the 99th percentile (p99) of a batch, or of everything a server has answered.
+//
+// Keeping every latency to sort later would cost memory in proportion to the number of queries, so
+// latencies are counted in buckets instead. The buckets are log-linear: every power of two of
+// nanoseconds is split into SUB_BUCKETS equal buckets, so a percentile is never off by more than
+// one part in SUB_BUCKETS, from nanoseconds up to minutes, with a fixed, small amount of memory.
+//
+// A histogram is not safe to record into from several threads at once. Each thread should keep its
+// own, and merge them once the threads are done.
+//
+
+using namespace std;
+
+class LatencyHistogram
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- starts with no latencies recorded
+    //
+    LatencyHistogram();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Records a latency, in seconds. Queries that were answered together, and so share a latency,
+    // can be recorded all at once by passing how many there were as times.
+    //
+    void record(double seconds, long long times = 1);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Adds every latency recorded in another histogram to this one.
+    //
+    void merge(const LatencyHistogram& other);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of latencies recorded.
+    //
+    long long getCount() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the given percentile of the recorded latencies, in seconds: the latency that
+    // percentile percent of them are no longer than. It is accurate to within one bucket, and
+    // never more than the longest latency recorded. Returns 0 if nothing has been recorded.
+    //
+    // percentile   from 0 to 100; 50 is the median
+    //
+    double getPercentile(double percentile) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the longest latency recorded, in seconds.
+    //
+    double getMaximum() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the average of the recorded latencies, in seconds.
+    //
+    double getMean() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a one-line summary of the histogram, such as "p50 12.5 us, p99 310 us, max 1.2 ms,
+    // mean 20.1 us over 1000 queries".
+    //
+    string format() const;
+
+
+private:
+
+    // The number of buckets each power of two is split into, and the number of powers of two
+    // covered; with nanoseconds, 2^42 is over an hour. Longer latencies go in the last bucket.
+    //
+    static const int SUB_BUCKETS = 8;
+    static const int MAGNITUDES = 42;
+
+    vector<long long> counts;       // The number of latencies in each bucket
+    long long count;                // The number of latencies recorded
+    double totalSeconds;            // The sum of the latencies recorded
+    double maximumSeconds;          // The longest latency recorded
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the bucket holding the given number of nanoseconds.
+    //
+    static int getBucket(uint64_t nanoseconds);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the longest latency, in nanoseconds, that falls in the given bucket.
+    //
+    static uint64_t getBucketLimit(int bucket);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the given number of seconds as text, in whichever of ns, us, ms or s reads best.
+    //
+    static string formatSeconds(double seconds);
+};
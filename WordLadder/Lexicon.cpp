@@ -0,0 +1,191 @@
+//==============================================================================================
+// File: Lexicon.cpp - Multi-length lexicon implementation
+// c.f.: Lexicon.h
+//
+// This class reads a lexicon file once and splits its words up by
+// length, then builds a WordLadder for each length the first time a
+// query of that length comes along.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "Lexicon.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+Lexicon::Lexicon(const string& lexiconFileName, WordLadder::NeighborEngine engine)
+{
+	// The constructor loads the lexicon, but doesn't build any
+	// partitions; each of those waits until it is first needed.
+	//
+	this->lexiconFileName = lexiconFileName;
+	this->engine = engine;
+
+	lexiconSize = -1;
+	lexiconHash = 0;
+
+	// If there is an up-to-date snapshot, we keep it mapped, and
+	// every partition is loaded from its own section of it later.
+	loadedFromSnapshot = snapshotFile.open(WordLadder::getSnapshotFileName(lexiconFileName)) &&
+		WordLadder::getFileFingerprint(lexiconFileName, lexiconSize, lexiconHash) &&
+		WordLadder::readSnapshotLengths(snapshotFile.getData(), snapshotFile.getSize(), lexiconSize, lexiconHash, wordLengths);
+
+	if (loadedFromSnapshot)
+	{
+		return;
+	}
+
+	snapshotFile.close();
+
+	// Otherwise, we read the text, just like WordLadder does, by mapping
+	// it if we can, and through an input stream if we can't.
+	MappedFile lexiconFile;
+
+	if (lexiconFile.open(lexiconFileName))
+	{
+		WordLadder::partitionWords(lexiconFile.getData(), lexiconFile.getSize(), wordsByLength);
+	}
+	else
+	{
+		ifstream inputStream(lexiconFileName);
+
+		if (inputStream.fail())
+		{
+			cout << "Unable to open lexicon file.\n";
+
+			exit(0); // There is nothing we can do without a lexicon, just like in WordLadder.
+		}
+
+		string word;
+
+		while (inputStream >> word)
+		{
+			if (word.length() >= wordsByLength.size())
+			{
+				wordsByLength.resize(word.length() + 1);
+			}
+
+			wordsByLength[word.length()].append(word);
+		}
+	}
+
+	for (unsigned int length = 1; length < wordsByLength.size(); length++)
+	{
+		if (!wordsByLength[length].empty())
+		{
+			wordLengths.push_back(length);
+		}
+	}
+}
+
+Lexicon::~Lexicon()
+{
+	for (const pair<const int, WordLadder*>& partition : partitions)
+	{
+		delete partition.second;
+	}
+}
+
+WordLadder& Lexicon::getWordLadder(int length)
+{
+	// We hold the lock while we look, and while we build, so
+	// that two threads asking for the same new length don't
+	// both build it. Once built, a partition never changes, so
+	// it is safe to use after the lock is released.
+	//
+	lock_guard<mutex> guard(partitionLock);
+
+	map<int, WordLadder*>::iterator found = partitions.find(length);
+
+	if (found != partitions.end())
+	{
+		return *found->second;
+	}
+
+	WordLadder* partition = buildPartition(length);
+
+	partitions[length] = partition;
+
+	return *partition;
+}
+
+void Lexicon::prepareLength(int length)
+{
+	getWordLadder(length);
+}
+
+vector<string> Lexicon::getMinLadder(const string& start, const string& end)
+{
+	if (start.length() != end.length())
+	{
+		return vector<string>();
+	}
+
+	return getWordLadder(start.length()).getMinLadder(start, end);
+}
+
+vector<int> Lexicon::getWordLengths() const
+{
+	return wordLengths;
+}
+
+bool Lexicon::isLoadedFromSnapshot() const
+{
+	return loadedFromSnapshot;
+}
+
+WordLadder* Lexicon::buildPartition(int length)
+{
+	// This method builds a partition the same way the WordLadder
+	// constructor would, except that the words come from what we
+	// have already loaded, instead of from the lexicon file.
+	//
+	bool hasWords = find(wordLengths.begin(), wordLengths.end(), length) != wordLengths.end();
+
+	// The file itself was read by our constructor, so a partition's
+	// load time is just the time to load its section, or sort its words.
+	chrono::steady_clock::time_point loadStart = chrono::steady_clock::now();
+
+	if (loadedFromSnapshot && hasWords)
+	{
+		WordLadder* partition = new WordLadder(length, engine);
+
+		partition->loadedFromSnapshot = partition->loadSnapshot(snapshotFile.getData(), snapshotFile.getSize(), lexiconSize, lexiconHash);
+
+		if (partition->loadedFromSnapshot)
+		{
+			chrono::duration<double> loadDuration = chrono::steady_clock::now() - loadStart;
+
+			partition->loadTime = loadDuration.count();
+			partition->buildIndex(); // This only builds what the snapshot didn't have.
+
+			return partition;
+		}
+
+		// The section must be damaged, so we load this
+		// one length from the text instead.
+		delete partition;
+
+		return new WordLadder(lexiconFileName, length, engine);
+	}
+
+	// Otherwise, the partition takes over the words we read for its
+	// length. A length with no words just gets an empty partition.
+	WordLadder* partition = new WordLadder(length, engine);
+
+	if (hasWords && !loadedFromSnapshot)
+	{
+		partition->packedWords.swap(wordsByLength[length]);
+	}
+
+	partition->sortPackedWords();
+
+	chrono::duration<double> loadDuration = chrono::steady_clock::now() - loadStart;
+
+	partition->loadTime = loadDuration.count();
+	partition->buildIndex();
+
+	return partition;
+}
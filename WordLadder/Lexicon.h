@@ -0,0 +1,116 @@
+#pragma once
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "WordLadder.h"
+
+//
+// Lexicon.h Defines a lexicon holding words of every length, which answers word ladder queries of any
+// length from a single load of the lexicon file.
+//
+// A WordLadder only keeps the words of one length, so answering queries of several lengths used to
+// mean one WordLadder, and one read of the lexicon file, per length. A Lexicon reads the file once,
+// splitting its words up by length as it goes, and then hands each length's words to its own
+// WordLadder -- a partition -- the first time a query of that length needs it. Lengths that are
+// never asked for are never indexed.
+//
+// If the lexicon file has an up-to-date snapshot (see WordLadder::writeSnapshot), the text isn't read
+// at all, and each partition is loaded from its section of the snapshot instead.
+//
+// Word IDs are per partition: a word's ID is its position among the words of its own length.
+//
+
+using namespace std;
+
+class Lexicon
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- loads the lexicon file, splitting its words up by length. Exits if the file
+    // can't be opened, just like the WordLadder constructor.
+    //
+    // engine  the neighbor engine every partition is built with
+    //
+    Lexicon(const string& lexiconFileName, WordLadder::NeighborEngine engine = WordLadder::GRAPH_ENGINE);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Destructor -- deletes every partition that was built
+    //
+    ~Lexicon();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the partition holding the words of the given length, building it if this is the first
+    // time it is asked for. A length with no words gets an empty partition, in which every query
+    // has no ladder. The partition lives as long as the Lexicon does.
+    //
+    // Any number of threads may call this at once; the first caller for a length builds its
+    // partition while the others wait. Call prepareLength ahead of time to keep that build out of
+    // the way of queries.
+    //
+    // length   the word length
+    // returns  the WordLadder for words of that length
+    //
+    WordLadder& getWordLadder(int length);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Builds the partition for the given length now, if it hasn't been built already.
+    //
+    void prepareLength(int length);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a minimum-length word ladder from start to end, from the partition for their length,
+    // following the contract of WordLadder::getMinLadder. Words of different lengths have no ladder.
+    //
+    // Like WordLadder::getMinLadder, this uses the partition's own workspace, so only one thread may
+    // call it at a time. Threads should instead search getWordLadder(length) with a workspace of
+    // their own.
+    //
+    vector<string> getMinLadder(const string& start, const string& end);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns every word length that has at least one word in the lexicon, in increasing order.
+    //
+    vector<int> getWordLengths() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns true if the partitions are loaded from a snapshot rather than the text lexicon.
+    //
+    bool isLoadedFromSnapshot() const;
+
+
+private:
+
+    string lexiconFileName;                 // The lexicon file, for partitions that must reread it
+    WordLadder::NeighborEngine engine;      // The engine every partition is built with
+
+    // The words of each length, packed end to end in file order, waiting for their partition to be
+    // built. A length's words are moved into its partition when it is built. Empty if the lexicon
+    // was loaded from a snapshot.
+    //
+    vector<string> wordsByLength;
+
+    vector<int> wordLengths;                // Every length with at least one word
+
+    MappedFile snapshotFile;                // The snapshot, kept mapped while partitions are built from it
+    long long lexiconSize;                  // The size of the lexicon file, to check the snapshot against,
+    unsigned long long lexiconHash;         // and the hash of its contents
+    bool loadedFromSnapshot;                // Whether the partitions come from the snapshot
+
+    map<int, WordLadder*> partitions;       // Every partition built so far, by word length
+    mutex partitionLock;                    // Guards partitions, and the building of a partition
+
+
+    //---------------------------------------------------------------------------------------------
+    // Builds and returns the partition for the given length. Called with partitionLock held.
+    //
+    WordLadder* buildPartition(int length);
+};
@@ -0,0 +1,71 @@
+//==============================================================================================
+// File: LiveWordLadder.cpp - Copy-on-write word ladder implementation
+// c.f.: LiveWordLadder.h
+//
+// This class lets a lexicon change while it is being queried, by making
+// every change to a copy of the current version and then swapping the
+// copy in, so that readers only ever see a version that is complete.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "LiveWordLadder.h"
+
+LiveWordLadder::LiveWordLadder(const string& lexiconFileName, int len, WordLadder::NeighborEngine engine)
+{
+	current = make_shared<WordLadder>(lexiconFileName, len, engine);
+}
+
+shared_ptr<const WordLadder> LiveWordLadder::getSnapshot() const
+{
+	return atomic_load(&current);
+}
+
+bool LiveWordLadder::addWord(const string& word)
+{
+	return applyChanges(vector<string>(1, word), vector<string>()) == 1;
+}
+
+bool LiveWordLadder::removeWord(const string& word)
+{
+	return applyChanges(vector<string>(), vector<string>(1, word)) == 1;
+}
+
+int LiveWordLadder::applyChanges(const vector<string>& additions, const vector<string>& removals)
+{
+	// We copy the current version and patch the copy, which
+	// nobody else can see yet. Readers can keep taking the
+	// current version the whole time, since only the swap at
+	// the end touches it, and that is atomic. Two updates at
+	// once would each copy the same version and one would lose
+	// the other's changes, so updates take turns. The copy
+	// doesn't bring along the current version's workspace,
+	// which readers never use anyway; they bring their own.
+	//
+	lock_guard<mutex> guard(updateLock);
+
+	shared_ptr<WordLadder> next = make_shared<WordLadder>(*atomic_load(&current));
+	int changes = 0;
+
+	for (const string& word : removals)
+	{
+		changes += next->removeWord(word);
+	}
+
+	for (const string& word : additions)
+	{
+		changes += next->addWord(word);
+	}
+
+	if (changes > 0) // An update that changed nothing isn't worth a new version.
+	{
+		atomic_store(&current, shared_ptr<const WordLadder>(next));
+	}
+
+	return changes;
+}
+
+unsigned long long LiveWordLadder::getGeneration() const
+{
+	return getSnapshot()->getGeneration();
+}
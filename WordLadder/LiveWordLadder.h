@@ -0,0 +1,84 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "WordLadder.h"
+
+//
+// LiveWordLadder.h Defines a word ladder whose lexicon can change while it is being queried.
+//
+// WordLadder::addWord and removeWord patch a lexicon in place, so no query may run on it at the same
+// time. A LiveWordLadder never changes a WordLadder that readers can see. An update copies the
+// current version, makes its changes to the copy, and then publishes the copy in a single atomic
+// step, in the manner of read-copy-update (RCU). Readers take the current version with getSnapshot,
+// and may query it for as long as they hold on to it: a query that was running when an update was
+// published finishes on the version it started with, and each old version is freed once its last
+// reader lets go of it. Readers never wait for updates, or for each other; updates only wait for
+// each other.
+//
+// Every update copies the whole lexicon, index included, and each change it makes then costs as
+// much again (see WordLadder::addWord), so an update takes O(V + E) time and memory, for V words
+// and E index entries -- on the order of milliseconds for a hundred thousand words. Changes are
+// best made in batches with applyChanges, which copies once for the whole batch. The copy leaves
+// out the current version's workspace, so a new version starts with an empty one.
+//
+// Each version has its own generation (see WordLadder::getGeneration), which goes up with every word
+// added or removed, so anything worked out from one version can be checked against the version in
+// use. A LadderCache does that check itself, but it is tied to a single WordLadder, so it needs to
+// be made again for each version.
+//
+
+using namespace std;
+
+class LiveWordLadder
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- loads the first version of the lexicon, exactly as the WordLadder constructor
+    // does
+    //
+    LiveWordLadder(const string& lexiconFileName, int len, WordLadder::NeighborEngine engine = WordLadder::GRAPH_ENGINE);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the current version of the word ladder. It is never changed, so any number of threads
+    // may query it at once, each with a workspace of its own, for as long as they hold on to it.
+    //
+    shared_ptr<const WordLadder> getSnapshot() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Publishes a new version with the given word added or removed. The return value is that of
+    // WordLadder::addWord or WordLadder::removeWord; if it is false, nothing is published.
+    //
+    bool addWord(const string& word);
+    bool removeWord(const string& word);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Publishes a new version with every word in removals removed, and then every word in additions
+    // added, so readers see either none of the changes or all of them. Words that can't be removed
+    // or added are skipped, just as removeWord and addWord would skip them.
+    //
+    // returns  the number of words removed or added; if none were, nothing is published
+    //
+    int applyChanges(const vector<string>& additions, const vector<string>& removals);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the generation of the current version.
+    //
+    unsigned long long getGeneration() const;
+
+
+private:
+
+    // The current version. Readers may take it while an update replaces it, so it is only ever
+    // read with atomic_load and replaced with atomic_store.
+    //
+    shared_ptr<const WordLadder> current;
+
+    mutex updateLock;               // Held by an update from copying the current version to publishing
+};
@@ -12,7 +12,18 @@
 // Date:       Apr 25, 2020
 // Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
 
+#include <algorithm>
+#include <csignal>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include "BatchSolver.h"
+#include "EditLadder.h"
+#include "LadderAnalyzer.h"
+#include "LadderEnumerator.h"
+#include "LadderServer.h"
+#include "LatencyHistogram.h"
+#include "Lexicon.h"
 #include "WordLadder.h"
 
 using namespace std;
@@ -32,6 +43,302 @@ void convertToUppercase(string& str)
 	}
 }
 
+void printStatistics(const WordLadder::SearchStatistics& statistics)
+{
+	// This method prints the statistics kept by the searches, for
+	// the --stats option, unless they were compiled out.
+	//
+	if (!WordLadder::hasStatistics())
+	{
+		cout << "Query statistics were compiled out of this build.\n";
+
+		return;
+	}
+
+	cout << "Searches for " << statistics.queries << (statistics.queries == 1 ? " query: " : " queries: ");
+	cout << statistics.dequeuedWords << " words dequeued, " << statistics.generatedNeighbors << " neighbors generated, ";
+	cout << statistics.visitedHits << " of them already visited, and at most " << statistics.peakQueueSize << " words queued.\n";
+	cout << "Search time " << statistics.searchSeconds * 1000 << " ms, ladder reconstruction time " << statistics.reconstructSeconds * 1000 << " ms.\n";
+}
+
+void printLoadTimes(const WordLadder& wordLadder)
+{
+	cout << "Loaded " << wordLadder.getWordCount() << " words in " << wordLadder.getLoadTime() * 1000 << " ms";
+	cout << (wordLadder.isLoadedFromSnapshot() ? " from the snapshot" : "") << ", and indexed them in " << wordLadder.getIndexBuildTime() * 1000 << " ms.\n";
+}
+
+int runBatch(const string& dictionaryFilePath, const string& pairsFilePath, bool stats)
+{
+	// This method answers a whole batch of queries, read as
+	// whitespace-separated "first_word last_word" pairs from the
+	// given file, or from standard input if no file was given.
+	// The dictionary is loaded once per word length, rather than
+	// once per query, and the results are printed in the same
+	// order as the pairs were read, one line per pair.
+	//
+	ifstream pairsFile;
+
+	if (!pairsFilePath.empty()) // If we were given a file of pairs, we try to open it.
+	{
+		pairsFile.open(pairsFilePath);
+
+		if (pairsFile.fail())
+		{
+			cout << "Unable to open pairs file.\n";
+
+			return 0;
+		}
+	}
+
+	istream& input = pairsFilePath.empty() ? cin : pairsFile;
+
+	vector<pair<string, string>> queries;	// Every query, in the order we read them
+	string firstWord;
+	string lastWord;
+
+	while (input >> firstWord >> lastWord) // While we can read another pair of words,
+	{
+		convertToUppercase(firstWord);	// we uppercase them both, just like a single query,
+		convertToUppercase(lastWord);
+
+		queries.push_back(make_pair(firstWord, lastWord)); // and add them to the batch.
+	}
+
+	// The lexicon keeps the words of each length apart, so we group the
+	// queries by length and answer each group with that length's WordLadder.
+	// Queries whose words differ in length don't go in any group.
+	map<int, vector<int>> queriesByLength;
+
+	for (unsigned int i = 0; i < queries.size(); i++)
+	{
+		if (queries[i].first.length() == queries[i].second.length())
+		{
+			queriesByLength[queries[i].first.length()].push_back(i);
+		}
+	}
+
+	vector<vector<string>> ladders(queries.size());
+	WordLadder::SearchStatistics statistics;	// The statistics of every length's searches, for --stats,
+	LatencyHistogram latencies;					// along with the latency of every query.
+	double loadTime = 0;
+
+	// We are answering many queries against the same lexicon, so the
+	// up-front cost of the full adjacency graph pays off. The lexicon
+	// file is read just once, however many lengths the batch uses.
+	Lexicon lexicon(dictionaryFilePath, WordLadder::GRAPH_ENGINE);
+
+	for (const pair<const int, vector<int>>& group : queriesByLength)
+	{
+		WordLadder& wordLadder = lexicon.getWordLadder(group.first);
+
+		vector<pair<string, string>> groupQueries;
+
+		for (int queryIndex : group.second)
+		{
+			groupQueries.push_back(queries[queryIndex]);
+		}
+
+		BatchSolver solver(wordLadder);
+
+		vector<vector<string>> groupLadders = solver.solve(groupQueries);
+
+		statistics.add(solver.getStatistics());
+		latencies.merge(solver.getLatencies());
+		loadTime += wordLadder.getLoadTime() + wordLadder.getIndexBuildTime();
+
+		for (unsigned int i = 0; i < group.second.size(); i++)
+		{
+			ladders[group.second[i]].swap(groupLadders[i]);
+		}
+	}
+
+	// Now that everything has been answered, we print the results in order.
+	for (unsigned int i = 0; i < queries.size(); i++)
+	{
+		if (queries[i].first.length() != queries[i].second.length())
+		{
+			cout << "The first and final word do not have the same length.\n";
+		}
+		else
+		{
+			lexicon.getWordLadder(queries[i].first.length()).displayResult(ladders[i]);
+		}
+	}
+
+	if (stats)
+	{
+		cout << "Sorted and indexed the words in " << loadTime * 1000 << " ms.\n";
+		printStatistics(statistics);
+
+		if (WordLadder::hasStatistics())
+		{
+			cout << "Latency: " << latencies.format() << ".\n";
+		}
+	}
+
+	return 0;
+}
+
+int runAnalysis(const string& dictionaryFilePath, const string& outputFilePath)
+{
+	// This method analyzes every word length of the dictionary,
+	// finding each component's diameter and the hardest pairs of
+	// words, and writes the whole analysis to a JSON file, as one
+	// object per word length. By default, the file goes next to
+	// the dictionary.
+	//
+	string analysisFilePath = outputFilePath.empty() ? dictionaryFilePath + ".analysis.json" : outputFilePath;
+
+	Lexicon lexicon(dictionaryFilePath, WordLadder::GRAPH_ENGINE);
+	ofstream outputFile(analysisFilePath);
+
+	if (!outputFile.is_open())
+	{
+		cout << "Unable to open " << analysisFilePath << " for writing.\n";
+
+		return 0;
+	}
+
+	outputFile << "[";
+
+	vector<int> lengths = lexicon.getWordLengths();
+
+	for (unsigned int i = 0; i < lengths.size(); i++)
+	{
+		LadderAnalyzer analyzer(lexicon.getWordLadder(lengths[i]));
+		const vector<int>& diameters = analyzer.getDiameters();
+		const vector<LadderAnalyzer::LadderPair>& hardestPairs = analyzer.getHardestPairs();
+
+		outputFile << (i == 0 ? "\n" : ",\n");
+		analyzer.writeJson(outputFile);
+
+		// We also print a summary of each length as we go, since
+		// the analysis of a big dictionary can take a while.
+		cout << lengths[i] << "-letter words: " << analyzer.getEccentricities().size() << " words in " << diameters.size() << " components, ";
+		cout << "largest diameter " << (diameters.empty() ? 0 : *max_element(diameters.begin(), diameters.end())) << " steps";
+
+		if (!hardestPairs.empty())
+		{
+			cout << ", e.g. " << hardestPairs[0].start << " to " << hardestPairs[0].end;
+		}
+
+		cout << ".\n" << flush;
+	}
+
+	outputFile << "\n]\n";
+
+	cout << "Wrote the analysis to " << analysisFilePath << ".\n";
+
+	return 0;
+}
+
+int runEditLadder(const string& dictionaryFilePath, const string& firstWord, const string& lastWord, bool stats)
+{
+	// This method finds a ladder in which each step may also add
+	// or remove a letter, so the two words needn't be the same
+	// length, and the ladder may pass through words of any length.
+	// Every length of the dictionary is searched at once, so we
+	// load all of them, without the neighbor indexes the other
+	// searches use, since the edit ladder builds its own.
+	//
+	string start = firstWord;
+	string end = lastWord;
+
+	convertToUppercase(start);
+	convertToUppercase(end);
+
+	Lexicon lexicon(dictionaryFilePath, WordLadder::SCAN_ENGINE);
+	EditLadder editLadder(lexicon);
+
+	EditLadder::displayResult(editLadder.getMinLadder(start, end));
+
+	if (stats)
+	{
+		cout << "Indexed the deletions of " << editLadder.getWordCount() << " words in " << editLadder.getIndexBuildTime() * 1000 << " ms.\n";
+		printStatistics(editLadder.getStatistics());
+	}
+
+	return 0;
+}
+
+LadderServer* runningServer = nullptr; // The server being run, for stopServer to stop
+
+void stopServer(int)
+{
+	// This is called when the user interrupts the program while
+	// it is serving, so that the server can shut down cleanly.
+	//
+	if (runningServer != nullptr)
+	{
+		runningServer->stop();
+	}
+}
+
+int runServer(const string& dictionaryFilePath, const string& address, bool stats)
+{
+	// This method runs the program as a server, which loads the
+	// dictionary once and then answers queries from clients until
+	// it is interrupted. An address made up only of digits is a
+	// TCP port on this machine; anything else is the path of a
+	// Unix domain socket.
+	//
+	Lexicon lexicon(dictionaryFilePath, WordLadder::GRAPH_ENGINE);
+
+	// Every length is indexed up front, so that no client has to
+	// wait for an index to be built in the middle of its queries.
+	for (int length : lexicon.getWordLengths())
+	{
+		lexicon.prepareLength(length);
+	}
+
+	LadderServer server(lexicon);
+	bool isPort = !address.empty() && address.find_first_not_of("0123456789") == string::npos;
+	bool listening;
+
+	if (isPort)
+	{
+		listening = address.length() <= 5 && stoi(address) <= 65535 && server.listenTcp(stoi(address));
+	}
+	else
+	{
+		listening = server.listenUnix(address);
+	}
+
+	if (!listening)
+	{
+		cout << "Unable to listen on " << address << ".\n";
+
+		return 0;
+	}
+
+	cout << "Listening on " << (isPort ? "localhost:" : "") << address << ".\n" << flush;
+
+	runningServer = &server;
+	signal(SIGINT, stopServer);
+	signal(SIGTERM, stopServer);
+
+	server.run();
+
+	runningServer = nullptr;
+
+	LadderCache::Statistics statistics = server.getCacheStatistics();
+
+	cout << "Ladder cache: " << statistics.ladderHits << " hits, " << statistics.ladderMisses << " misses. ";
+	cout << "Tree cache: " << statistics.treeHits << " hits, " << statistics.treeMisses << " misses, " << statistics.treesBuilt << " trees built.\n";
+
+	if (stats)
+	{
+		printStatistics(server.getSearchStatistics());
+
+		if (WordLadder::hasStatistics())
+		{
+			cout << "Latency: " << server.getLatencies().format() << ".\n";
+		}
+	}
+
+	return 0;
+}
+
 int main(int argc, char* argv[])
 {
 	// This is the entry point of the application, so we check
@@ -40,22 +347,101 @@ int main(int argc, char* argv[])
 	// words the user provides, using the dictionary provided
 	// in the arguments.
 	//
-	if (argc != 4) // If our argument count isn't exactly four,
+	// Besides the three required arguments, a fourth, optional
+	// argument picks a different search: "--bidirectional" finds the
+	// ladder with a bidirectional search, "--parallel" with a
+	// breadth-first search spread across every hardware thread, and
+	// "--astar" with an A* search, so they can be compared with the
+	// plain search. "--all" prints every minimum ladder instead of
+	// just one, after saying how many there are, and "--edits" lets
+	// each step add or remove a letter as well as change one, so
+	// the two words may differ in length.
+	//
+	// Alternatively, "--batch" in place of the two words answers a
+	// batch of word pairs read from a file, or from standard input,
+	// and "--build-snapshot" writes a snapshot of the dictionary next
+	// to it, which every later run then loads instead of the text.
+	// "--analyze" writes the diameters, hardest pairs and every
+	// word's eccentricity to a JSON file, named by an optional
+	// argument. Finally, "--serve" followed by a port number or a
+	// socket path keeps the dictionary loaded and answers queries
+	// over a socket.
+	//
+	// Any of these but the snapshot and the analysis may end with
+	// "--stats", which prints how long loading took and what the
+	// searches did, and in batch and server mode, the median and
+	// 99th percentile query latencies. We take it off the end, so
+	// the other arguments can be checked as if it weren't there.
+	//
+	bool stats = argc > 3 && string(argv[argc - 1]) == "--stats";
+
+	if (stats)
+	{
+		argc--;
+	}
+
+	bool bidirectional = argc == 5 && string(argv[4]) == "--bidirectional";
+	bool parallel = argc == 5 && string(argv[4]) == "--parallel";
+	bool aStar = argc == 5 && string(argv[4]) == "--astar";
+	bool all = argc == 5 && string(argv[4]) == "--all";
+	bool edits = argc == 5 && string(argv[4]) == "--edits";
+	bool batch = (argc == 3 || argc == 4) && string(argv[2]) == "--batch";
+	bool buildSnapshot = argc == 3 && string(argv[2]) == "--build-snapshot";
+	bool analyze = (argc == 3 || argc == 4) && string(argv[2]) == "--analyze";
+	bool serve = argc == 4 && string(argv[2]) == "--serve";
+
+	if (argc != 4 && !bidirectional && !parallel && !aStar && !all && !edits && !batch && !buildSnapshot && !analyze) // If our arguments aren't one of those forms,
 	{
 		// Tell the user the wrong number of arguments was provided,
 		// and give them an example usage of the program so that
 		// they know how to use it!
 		//
 		cout << "Wrong number of arguments provided. Example usage:\n";
-		cout << "WordLadder dictionary_file_path first_word last_word\n";
+		cout << "WordLadder dictionary_file_path first_word last_word [--bidirectional | --parallel | --astar | --all | --edits] [--stats]\n";
+		cout << "WordLadder dictionary_file_path --batch [pairs_file_path] [--stats]\n";
+		cout << "WordLadder dictionary_file_path --build-snapshot\n";
+		cout << "WordLadder dictionary_file_path --analyze [output_file_path]\n";
+		cout << "WordLadder dictionary_file_path --serve port | socket_path [--stats]\n";
 
 		return 0; // There is nothing left to do, so we can return here, ending the program.
 	}
 
+	if (batch)
+	{
+		return runBatch(argv[1], argc == 4 ? argv[3] : "", stats);
+	}
+
+	if (serve)
+	{
+		return runServer(argv[1], argv[3], stats);
+	}
+
+	if (analyze)
+	{
+		return runAnalysis(argv[1], argc == 4 ? argv[3] : "");
+	}
+
+	if (buildSnapshot)
+	{
+		int sectionCount = WordLadder::writeSnapshot(argv[1]);
+
+		if (sectionCount >= 0)
+		{
+			cout << "Wrote " << sectionCount << " word lengths to " << WordLadder::getSnapshotFileName(argv[1]) << ".\n";
+		}
+
+		return 0;
+	}
+
 	string dictionaryFilePath = argv[1];	// Get the file path to the dictionary
 	string firstWord = argv[2];				// Get the word we are going to be starting at
 	string lastWord = argv[3];				// Get the word we will be ending at
 
+	if (edits) // Edit ladders are the one kind that can join words of different lengths.
+	{
+		return runEditLadder(dictionaryFilePath, firstWord, lastWord, stats);
+	}
+
 	if (firstWord.length() != lastWord.length()) // If the words aren't equal the same length,
 	{
 		// we tell the user that they don't have the same length.
@@ -75,7 +461,11 @@ int main(int argc, char* argv[])
 	// a WordLadder successfully being constructed means that we
 	// can continue and find our minimum word ladder.
 	//
-	WordLadder wordLadder(dictionaryFilePath, firstWord.length());
+	// Since we only answer a single query, we ask for the bucket
+	// engine, which is much cheaper to build than the full adjacency
+	// graph and just as correct.
+	//
+	WordLadder wordLadder(dictionaryFilePath, firstWord.length(), WordLadder::BUCKET_ENGINE);
 
 	// We call convertToUppercase on both our first and last
 	// words. As seen in the comments for this method, it does
@@ -90,13 +480,63 @@ int main(int argc, char* argv[])
 	convertToUppercase(firstWord);
 	convertToUppercase(lastWord);
 
+	// If the user asked for every minimum ladder, we let a
+	// LadderEnumerator find them. It only holds one ladder at a
+	// time, so we print each one as soon as we get it, since
+	// there can be far too many to keep.
+	//
+	if (all)
+	{
+		LadderEnumerator enumerator(wordLadder, firstWord, lastWord);
+		vector<string> ladder;
+
+		if (enumerator.getStepCount() == -1) // There are no ladders at all,
+		{
+			wordLadder.displayResult(ladder); // so we say so the usual way.
+
+			return 0;
+		}
+
+		cout << "Found " << enumerator.getLadderCount() << " shortest word ladders of " << enumerator.getStepCount() << " steps, through " << enumerator.getWordCount() << " words:\n";
+
+		while (enumerator.next(ladder))
+		{
+			wordLadder.displayResult(ladder);
+		}
+
+		if (stats)
+		{
+			printLoadTimes(wordLadder);
+		}
+
+		return 0;
+	}
+
 	// We now retrieve the minimum word ladder, going from our first word
 	// to our last word. This will cause the WordLadder class to go loop
 	// the neighbors for the first word, checking them to find a connection
 	// that leads to the last word. If no connection can be found, an empty
 	// vector ends up getting returned.
 	//
-	vector<string> minLadder = wordLadder.getMinLadder(firstWord, lastWord);
+	vector<string> minLadder;
+	WordLadder::SearchWorkspace aStarState; // This keeps count of the words A* expands.
+
+	if (bidirectional)
+	{
+		minLadder = wordLadder.getMinLadderBidirectional(firstWord, lastWord);
+	}
+	else if (parallel)
+	{
+		minLadder = wordLadder.getMinLadderParallel(firstWord, lastWord);
+	}
+	else if (aStar)
+	{
+		minLadder = wordLadder.getMinLadderAStar(firstWord, lastWord, aStarState);
+	}
+	else
+	{
+		minLadder = wordLadder.getMinLadder(firstWord, lastWord);
+	}
 
 	// We now display our minimum word ladder. If the vector ends up
 	// being empty, the output will state that no solution was found.
@@ -106,5 +546,35 @@ int main(int argc, char* argv[])
 	//
 	wordLadder.displayResult(minLadder);
 
+	// For A*, we also show how much of the lexicon it had to expand,
+	// next to how much the plain breadth-first search expands for the
+	// same words, which is the whole point of using it.
+	//
+	if (aStar)
+	{
+		WordLadder::SearchWorkspace breadthFirstState;
+
+		wordLadder.getMinLadder(firstWord, lastWord, breadthFirstState);
+
+		cout << "A* expanded " << aStarState.expandedWords << " words; breadth-first search expanded " << breadthFirstState.expandedWords << ".\n";
+	}
+
+	// With --stats, we finish by showing where the time went. The
+	// parallel search has no workspace, so it keeps no statistics.
+	//
+	if (stats)
+	{
+		printLoadTimes(wordLadder);
+
+		if (parallel)
+		{
+			cout << "The parallel search keeps no query statistics.\n";
+		}
+		else
+		{
+			printStatistics(aStar ? aStarState.statistics : wordLadder.getStatistics());
+		}
+	}
+
 	return 0; // We return 0, as we have done all we needed to do!
 }
\ No newline at end of file
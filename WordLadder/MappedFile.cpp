@@ -0,0 +1,185 @@
+//==============================================================================================
+// File: MappedFile.cpp - Read-only memory-mapped files
+// c.f.: MappedFile.h
+//
+// This class maps a whole file into memory for reading, using the
+// Windows file mapping functions on Windows and mmap elsewhere.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+	data = nullptr;
+	size = 0;
+
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = nullptr;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const string& fileName)
+{
+	// This method maps the given file. An empty file can't be
+	// mapped on either platform, but it is still a perfectly
+	// good file, so we treat it as mapped with no data.
+	//
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(file, &fileSize) || (unsigned long long)fileSize.QuadPart > (size_t)-1)
+	{
+		CloseHandle(file);
+
+		return false;
+	}
+
+	fileHandle = file;
+
+	if (fileSize.QuadPart == 0)
+	{
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (mapping == nullptr)
+	{
+		close();
+
+		return false;
+	}
+
+	mappingHandle = mapping;
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (view == nullptr)
+	{
+		close();
+
+		return false;
+	}
+
+	data = (const char*)view;
+	size = (size_t)fileSize.QuadPart;
+#else
+	int file = ::open(fileName.c_str(), O_RDONLY);
+
+	if (file == -1)
+	{
+		return false;
+	}
+
+	struct stat fileStatus;
+
+	// Only regular files can be mapped; anything else, like a pipe,
+	// has to be read the ordinary way.
+	if (fstat(file, &fileStatus) == -1 || !S_ISREG(fileStatus.st_mode))
+	{
+		::close(file);
+
+		return false;
+	}
+
+	if (fileStatus.st_size == 0)
+	{
+		::close(file);
+
+		return true;
+	}
+
+	void* view = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+	// Once the file is mapped, the mapping keeps it alive on its own,
+	// so we can close the descriptor straight away.
+	::close(file);
+
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	// We're about to read the file from front to back, so we let the
+	// kernel know it can read ahead aggressively.
+	madvise(view, fileStatus.st_size, MADV_SEQUENTIAL);
+
+	data = (const char*)view;
+	size = fileStatus.st_size;
+#endif
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	// This method releases whatever open managed to set up,
+	// in the reverse of the order it was set up in.
+	//
+#ifdef _WIN32
+	if (data != nullptr)
+	{
+		UnmapViewOfFile(data);
+	}
+
+	if (mappingHandle != nullptr)
+	{
+		CloseHandle(mappingHandle);
+	}
+
+	if (fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(fileHandle);
+	}
+
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = nullptr;
+#else
+	if (data != nullptr)
+	{
+		munmap((void*)data, size);
+	}
+#endif
+
+	data = nullptr;
+	size = 0;
+}
+
+const char* MappedFile::getData() const
+{
+	return data;
+}
+
+size_t MappedFile::getSize() const
+{
+	return size;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+//
+// MappedFile.h Defines a read-only, memory-mapped view of a whole file.
+//
+// Mapping a file lets the operating system page it straight into our address space, so it can be
+// scanned in place, without copying it through a stream buffer or allocating anything per token.
+// This is used to load lexicon files, which can run to hundreds of megabytes.
+//
+// On Windows the file is mapped with CreateFileMapping and MapViewOfFile; everywhere else, with
+// mmap. The mapping is released when the object is destroyed, so the data pointer must not be
+// used after that.
+//
+
+using namespace std;
+
+class MappedFile
+{
+public:
+
+    //---------------------------------------------------------------------------------------------
+    // Constructor -- creates an object with nothing mapped
+    //
+    MappedFile();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Destructor -- unmaps the file, if one is mapped
+    //
+    ~MappedFile();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Maps the whole of the given file, read-only. Anything mapped before is unmapped first.
+    //
+    // fileName  the path of the file to map
+    // returns   true if the file was mapped, false if it could not be opened or mapped
+    //
+    bool open(const string& fileName);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Unmaps the file, if one is mapped.
+    //
+    void close();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a pointer to the first byte of the file, or nullptr if the file is empty or nothing
+    // is mapped. The bytes are not null-terminated.
+    //
+    const char* getData() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the size of the mapped file in bytes.
+    //
+    size_t getSize() const;
+
+
+private:
+
+    const char* data;       // The start of the mapping
+    size_t size;            // The length of the mapping
+
+#ifdef _WIN32
+    void* fileHandle;       // The file and its mapping object, which Windows needs kept open
+    void* mappingHandle;    // for as long as the view is mapped
+#endif
+
+    // A mapping can't be shared between two objects, as both would try to release it.
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+};
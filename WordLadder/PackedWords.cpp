@@ -0,0 +1,166 @@
+//==============================================================================================
+// File: PackedWords.cpp - Length-specialized engines for bit-packed words
+// c.f.: PackedWords.h
+//
+// This file implements the operations on words packed five bits to a
+// letter, as a template on the word length, and keeps one instance of
+// it for every length up to MAX_PACKED_LENGTH.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "PackedWords.h"
+#include <algorithm>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	//------------------------------------------------------------------------------------------
+	// Returns the number of bits set in the mask.
+	//
+	inline int countBits(PackedCode mask)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		return (int)__popcnt64(mask);
+#elif defined(__GNUC__) || defined(__clang__)
+		return __builtin_popcountll(mask);
+#else
+		int count = 0;
+
+		for (; mask != 0; mask &= mask - 1)
+		{
+			count++;
+		}
+
+		return count;
+#endif
+	}
+
+	//------------------------------------------------------------------------------------------
+	// The lowest bit of every one of the first L lanes, worked out at compile time.
+	//
+	template <int L>
+	struct LaneBits
+	{
+		static const PackedCode value = (LaneBits<L - 1>::value << PACKED_LETTER_BITS) | 1;
+	};
+
+	template <>
+	struct LaneBits<0>
+	{
+		static const PackedCode value = 0;
+	};
+
+	//------------------------------------------------------------------------------------------
+	// The engine for words of length L.
+	//
+	template <int L>
+	struct PackedWord
+	{
+		static bool encode(const char* word, PackedCode& code)
+		{
+			// Subtracting 'A' as unsigned turns every character
+			// before it into a large number, so one comparison
+			// rejects anything outside A to Z.
+			//
+			PackedCode packed = 0;
+
+			for (int i = 0; i < L; i++)
+			{
+				unsigned int letter = (unsigned int)(unsigned char)word[i] - 'A';
+
+				if (letter >= 26)
+				{
+					return false;
+				}
+
+				packed = (packed << PACKED_LETTER_BITS) | (letter + 1);
+			}
+
+			code = packed;
+
+			return true;
+		}
+
+		// Returns a mask with the lowest bit of every lane in which the codes differ set.
+		static PackedCode getMismatches(PackedCode first, PackedCode second)
+		{
+			// Shifting the difference down by one to four bits and
+			// ORing it all together lands any bit set in a lane on
+			// that lane's lowest bit. The bits shifted in from the
+			// lane above only land on the higher bits of each lane,
+			// which the mask then clears.
+			//
+			PackedCode difference = first ^ second;
+
+			difference |= (difference >> 1) | (difference >> 2) | (difference >> 3) | (difference >> 4);
+
+			return difference & LaneBits<L>::value;
+		}
+
+		static int getDistance(PackedCode first, PackedCode second)
+		{
+			return countBits(getMismatches(first, second));
+		}
+
+		static int findCode(const PackedCode* codes, int count, PackedCode code)
+		{
+			const PackedCode* found = std::lower_bound(codes, codes + count, code);
+
+			return found != codes + count && *found == code ? (int)(found - codes) : -1;
+		}
+
+		static int findDistanceOneCodes(const PackedCode* codes, int count, PackedCode query, int* matches)
+		{
+			// Every index is written, but the count only moves past
+			// it for a match, so the next index overwrites any that
+			// wasn't. That keeps the loop free of branches.
+			//
+			int matchCount = 0;
+
+			for (int i = 0; i < count; i++)
+			{
+				PackedCode mismatches = getMismatches(codes[i], query);
+
+				matches[matchCount] = i;
+				matchCount += mismatches != 0 && (mismatches & (mismatches - 1)) == 0;
+			}
+
+			return matchCount;
+		}
+
+		static const PackedWordEngine engine;
+	};
+
+	template <int L>
+	const PackedWordEngine PackedWord<L>::engine =
+	{
+		&PackedWord<L>::encode,
+		&PackedWord<L>::getDistance,
+		&PackedWord<L>::findCode,
+		&PackedWord<L>::findDistanceOneCodes
+	};
+}
+
+const PackedWordEngine* getPackedWordEngine(int wordLength)
+{
+	switch (wordLength)
+	{
+	case 1: return &PackedWord<1>::engine;
+	case 2: return &PackedWord<2>::engine;
+	case 3: return &PackedWord<3>::engine;
+	case 4: return &PackedWord<4>::engine;
+	case 5: return &PackedWord<5>::engine;
+	case 6: return &PackedWord<6>::engine;
+	case 7: return &PackedWord<7>::engine;
+	case 8: return &PackedWord<8>::engine;
+	case 9: return &PackedWord<9>::engine;
+	case 10: return &PackedWord<10>::engine;
+	case 11: return &PackedWord<11>::engine;
+	case 12: return &PackedWord<12>::engine;
+	default: return nullptr; // Longer words don't fit in a code.
+	}
+}
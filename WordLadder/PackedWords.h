@@ -0,0 +1,89 @@
+#pragma once
+
+//
+// PackedWords.h Defines the engines for lexicons whose words pack into a single 64-bit integer.
+//
+// A word made only of the letters A to Z needs five bits per letter, so a word of up to
+// MAX_PACKED_LENGTH (12) letters fits in one integer, its code, with its first letter in the highest
+// lane. Letters are numbered from 1, so codes compare in the same order as the words they spell,
+// and a sorted lexicon has sorted codes. Two codes are equal exactly when their words are, and the
+// code itself serves as a perfect hash.
+//
+// Comparing two words then takes a few integer operations instead of a loop over their letters:
+// XOR the codes, fold each 5-bit lane down onto its lowest bit, and count the bits that are left,
+// which is the Hamming distance. The words differ in exactly one position when a single bit is left.
+//
+// There is one engine per word length, each a template specialized on the length, so that every
+// loop over the letters is unrolled and every mask is a constant. The engine is chosen at runtime,
+// from the length a WordLadder is constructed with.
+//
+
+typedef unsigned long long PackedCode;
+
+// The longest word that fits in a code, and the bits each letter takes.
+const int MAX_PACKED_LENGTH = 12;
+const int PACKED_LETTER_BITS = 5;
+
+
+//-------------------------------------------------------------------------------------------------
+// The operations of the engine for one word length.
+//
+struct PackedWordEngine
+{
+    //---------------------------------------------------------------------------------------------
+    // Packs a word into a code.
+    //
+    // word     the characters of the word, which must be exactly the engine's length
+    // code     set to the word's code
+    // returns  true if the word was packed, false if it has a character other than A to Z
+    //
+    bool (*encode)(const char* word, PackedCode& code);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of positions at which the words with the given codes differ.
+    //
+    int (*getDistance)(PackedCode first, PackedCode second);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the index of the given code in a sorted array of codes, or -1 if it isn't there.
+    //
+    int (*findCode)(const PackedCode* codes, int count, PackedCode code);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Finds every code in an array whose word differs from the query's in exactly one position,
+    // just like findDistanceOneWords in HammingKernel.h does for packed characters.
+    //
+    // matches  receives the index of every match, in increasing order; it must have room for count
+    //          entries
+    // returns  the number of matches written
+    //
+    int (*findDistanceOneCodes)(const PackedCode* codes, int count, PackedCode query, int* matches);
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns the engine for words of the given length, or null if they are too long to pack.
+//
+const PackedWordEngine* getPackedWordEngine(int wordLength);
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns the bits of a code that hold the letter at the given position of a word of the given
+// length. Clearing them gives the word's pattern with that position masked.
+//
+inline PackedCode getPackedLaneMask(int wordLength, int position)
+{
+    return (PackedCode)((1 << PACKED_LETTER_BITS) - 1) << (PACKED_LETTER_BITS * (wordLength - 1 - position));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns the given letter, A to Z, in the lane of the given position of a word of the given length.
+//
+inline PackedCode getPackedLetter(int wordLength, int position, char letter)
+{
+    return (PackedCode)(letter - 'A' + 1) << (PACKED_LETTER_BITS * (wordLength - 1 - position));
+}
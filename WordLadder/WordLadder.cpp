@@ -19,11 +19,16 @@
 // Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
 
 #include "WordLadder.h"
+#include "HammingKernel.h"
+#include "MappedFile.h"
+#include "PackedWords.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <iostream>
-#include <list>
 
-WordLadder::WordLadder(string lexiconFileName, int len)
+WordLadder::WordLadder(const string& lexiconFileName, int len, NeighborEngine engine)
 {
 	// The constructor for our word ladder. We need to
 	// intialize our lexicon with words from the given
@@ -31,186 +36,1578 @@ WordLadder::WordLadder(string lexiconFileName, int len)
 	// parameter to optimize the lexicon so that it
 	// only contains words with the same length.
 	//
+	this->engine = engine;	// We remember which neighbor index we were asked to build,
+	wordLength = len;		// as well as the length of every word we will keep.
+	packedEngine = nullptr;	// The words are only packed once they're all loaded.
+	generation = 0;
+
+	// Loading the words is timed apart from building the index,
+	// since a snapshot makes one of them cheap but not the other.
+	chrono::steady_clock::time_point loadStart = chrono::steady_clock::now();
+
+	// If there is a usable snapshot of the lexicon, it already holds
+	// the sorted words and their index, so we're almost done.
+	// The mapping is only needed while we copy our section out of it.
+	// The lexicon is only hashed if there is a snapshot to check it against.
+	MappedFile snapshotFile;
+	long long lexiconSize;
+	unsigned long long lexiconHash;
+
+	loadedFromSnapshot = snapshotFile.open(getSnapshotFileName(lexiconFileName)) &&
+		getFileFingerprint(lexiconFileName, lexiconSize, lexiconHash) &&
+		loadSnapshot(snapshotFile.getData(), snapshotFile.getSize(), lexiconSize, lexiconHash);
+
+	snapshotFile.close();
+
+	if (!loadedFromSnapshot)
+	{
+		// We first try to map the lexicon file straight into memory, which
+		// lets us pick the words out of it in place. Anything that can't be
+		// mapped, like a pipe, is read through an input stream instead.
+		MappedFile lexiconFile;
+
+		if (lexiconFile.open(lexiconFileName))
+		{
+			readWords(lexiconFile.getData(), lexiconFile.getSize());
+		}
+		else
+		{
+			readWords(lexiconFileName);
+		}
+
+		// The words went into the buffer in file order, so
+		// we sort them to give every word its final ID.
+		sortPackedWords();
+	}
+
+	chrono::duration<double> loadDuration = chrono::steady_clock::now() - loadStart;
+
+	loadTime = loadDuration.count();
+
+	// Now that the lexicon is loaded, we build its neighbor index
+	// once, so that every query afterwards can simply use it instead
+	// of rescanning the whole lexicon for every word it visits.
+	buildIndex();
+}
+
+WordLadder::WordLadder(int len, NeighborEngine engine)
+{
+	// This constructor sets up an empty lexicon of the given
+	// length. Whoever creates it fills in the words, so there
+	// is nothing else to do until they have.
+	//
+	this->engine = engine;
+	wordLength = len;
+	wordCount = 0;
+	packedEngine = nullptr;
+	generation = 0;
+	loadedFromSnapshot = false;
+	indexBuildTime = 0;
+	loadTime = 0;
+}
+
+WordLadder::WordLadder(const WordLadder& other)
+{
+	// This constructor copies everything but the workspace,
+	// which only ever holds the scratch state of old searches.
+	// A copy that is about to be changed would just be carrying
+	// it around, and its statistics belong to the other instance.
+	//
+	packedWords = other.packedWords;
+	wordCount = other.wordCount;
+	wordCodes = other.wordCodes;
+	packedEngine = other.packedEngine;
+	engine = other.engine;
+	loadedFromSnapshot = other.loadedFromSnapshot;
+	adjacencyOffsets = other.adjacencyOffsets;
+	adjacencyTargets = other.adjacencyTargets;
+	bucketOffsets = other.bucketOffsets;
+	bucketWords = other.bucketWords;
+	wordBuckets = other.wordBuckets;
+	wordComponents = other.wordComponents;
+	componentSizes = other.componentSizes;
+	wordLength = other.wordLength;
+	generation = other.generation;
+	indexBuildTime = other.indexBuildTime;
+	loadTime = other.loadTime;
+}
+
+void WordLadder::readWords(const char* text, size_t length)
+{
+	// This method picks the words out of the lexicon file's text
+	// in place. A word is any run of characters that aren't
+	// whitespace, just like reading with >> would give us, but
+	// we never copy a word anywhere unless it is the right length,
+	// so the whole file is read without allocating per word.
+	//
+	const char* position = text;
+	const char* end = text + length;
+
+	while (position < end)
+	{
+		while (position < end && isWhitespace(*position)) // We skip past the whitespace before the next word,
+		{
+			position++;
+		}
+
+		const char* wordStart = position;
+
+		while (position < end && !isWhitespace(*position)) // and then past the word itself.
+		{
+			position++;
+		}
+
+		if (position - wordStart == wordLength) // If the word has the length we're keeping,
+		{
+			packedWords.append(wordStart, wordLength); // we append it to the end of our packed lexicon.
+		}
+	}
+}
+
+void WordLadder::partitionWords(const char* text, size_t length, vector<string>& wordsByLength)
+{
+	// This method splits the lexicon file's text into words the
+	// same way readWords does, but keeps every word, filing each
+	// one under its length, so the file only has to be read once
+	// no matter how many lengths we end up needing.
+	//
+	const char* position = text;
+	const char* end = text + length;
+
+	while (position < end)
+	{
+		while (position < end && isWhitespace(*position))
+		{
+			position++;
+		}
+
+		const char* wordStart = position;
+
+		while (position < end && !isWhitespace(*position))
+		{
+			position++;
+		}
+
+		size_t wordSize = position - wordStart;
+
+		if (wordSize > 0)
+		{
+			if (wordSize >= wordsByLength.size())
+			{
+				wordsByLength.resize(wordSize + 1);
+			}
+
+			wordsByLength[wordSize].append(wordStart, wordSize);
+		}
+	}
+}
+
+bool WordLadder::isWhitespace(char c)
+{
+	// These are the characters >> treats as whitespace in the "C" locale.
+	//
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+void WordLadder::readWords(const string& lexiconFileName)
+{
+	// This method reads the words of the lexicon file through an
+	// input stream, keeping the ones of the right length. It is
+	// only used for files that can't be memory-mapped.
+	//
 	ifstream inputStream; // We need an input stream to read our lexicon file
 
-	// Open the input stream with the lexicon file name as our path.
-	inputStream.open(lexiconFileName);
+	// Open the input stream with the lexicon file name as our path.
+	inputStream.open(lexiconFileName);
+
+	if (inputStream.fail()) // If the input straem fails to open,
+	{
+		cout << "Unable to open lexicon file.\n"; // we print a message saying we could not open the lexicon file,
+
+		// and exit our application, as there is nothing we can do without a valid lexicon.
+		// NOTE: If this implementation would be used as part of a different program, it would
+		// be much better if on failure, we throw an exception or somehow notify the caller
+		// that an error occurred - blindly exiting the program is usually not a good look
+		// for a constructor like this!
+		//
+		exit(0);
+	}
+
+	string word; // We will use this to hold the word we are currently reading from our lexicon file.
+
+	// While we successfully read another word from the input stream into our word variable...
+	while (inputStream >> word)
+	{
+		if ((int)word.length() == wordLength)	// if the word's length equals the length of the words that will be in our ladder,
+		{
+			packedWords.append(word);	// we append the word to the end of our packed lexicon.
+		}
+	}
+
+	// We've finished reading all of the words from
+	// the input stream, so we can close it now.
+	inputStream.close();
+}
+
+void WordLadder::buildIndex()
+{
+	// This method builds whichever neighbor index the selected
+	// engine needs, and times how long it takes so the cost can
+	// be reported separately from the cost of queries.
+	//
+	// An index that came from a snapshot is already in place, so we
+	// only build one when its offsets are missing.
+	//
+	chrono::steady_clock::time_point buildStart = chrono::steady_clock::now();
+
+	encodeWords(); // Every index below compares words, which is quicker once they're packed.
+
+	if (engine == BUCKET_ENGINE && bucketOffsets.empty())
+	{
+		buildBuckets();
+	}
+	else if (engine == GRAPH_ENGINE && (int)adjacencyOffsets.size() != wordCount + 1)
+	{
+		buildGraph();
+	}
+
+	// The scan engine has no index at all, so there is nothing to build for it.
+
+	buildComponents();
+
+	chrono::duration<double> buildDuration = chrono::steady_clock::now() - buildStart;
+
+	indexBuildTime = buildDuration.count();
+}
+
+void WordLadder::encodeWords()
+{
+	// This method packs every word into a single integer, if
+	// the words are short enough to fit and use only the
+	// letters A to Z. A single word with anything else in it
+	// means the whole lexicon keeps using the characters.
+	//
+	wordCodes.clear();
+	packedEngine = getPackedWordEngine(wordLength);
+
+	if (packedEngine == nullptr) // The words are too long to fit in an integer.
+	{
+		return;
+	}
+
+	wordCodes.resize(wordCount);
+
+	for (int id = 0; id < wordCount; id++)
+	{
+		if (!packedEngine->encode(getWordData(id), wordCodes[id]))
+		{
+			wordCodes.clear();
+			wordCodes.shrink_to_fit();
+			packedEngine = nullptr;
+
+			return;
+		}
+	}
+}
+
+void WordLadder::buildGraph()
+{
+	// This method builds the adjacency graph of the lexicon in
+	// compressed sparse row form. Each word gets an integer ID,
+	// and all of the neighbor lists are stored back to back in
+	// one vector, with a second vector telling us where each
+	// word's list starts. This keeps the whole graph in two
+	// contiguous blocks of memory.
+	//
+	// Rather than comparing every pair of words, which would be
+	// quadratic in the size of the lexicon, we generate every
+	// string that is one substitution away from each word and
+	// look it up with a binary search.
+	//
+	// We only try substituting characters that actually appear somewhere
+	// in the lexicon -- any other substitution can never produce a word.
+	string alphabet;
+
+	for (char c : packedWords)
+	{
+		if (alphabet.find(c) == string::npos)
+		{
+			alphabet.push_back(c);
+		}
+	}
+
+	adjacencyOffsets.assign(wordCount + 1, 0);
+	adjacencyTargets.clear();
+
+	for (int id = 0; id < wordCount; id++)
+	{
+		// Every word's neighbor list begins wherever the previous one ended.
+		adjacencyOffsets[id] = adjacencyTargets.size();
+
+		if (packedEngine != nullptr) // With packed words, we edit the word's code instead,
+		{
+			for (int position = 0; position < wordLength; position++)
+			{
+				// Clearing the position's lane leaves the pattern, and
+				// each character we try is ORed into it. The order is
+				// the same as below, so the graph comes out the same.
+				PackedCode pattern = wordCodes[id] & ~getPackedLaneMask(wordLength, position);
+
+				for (char c : alphabet)
+				{
+					PackedCode candidate = pattern | getPackedLetter(wordLength, position, c);
+
+					if (candidate == wordCodes[id])
+					{
+						continue;
+					}
+
+					int neighborId = packedEngine->findCode(wordCodes.data(), wordCount, candidate);
+
+					if (neighborId != -1)
+					{
+						adjacencyTargets.push_back(neighborId);
+					}
+				}
+			}
+
+			continue;
+		}
+
+		string candidate = getWord(id); // We edit a copy of the word in place, one position at a time.
+
+		for (unsigned int position = 0; position < candidate.length(); position++)
+		{
+			char original = candidate[position];
+
+			for (char c : alphabet)
+			{
+				if (c == original) // Putting back the same character would just give us the word itself,
+				{
+					continue; // so we skip it.
+				}
+
+				candidate[position] = c;
+
+				int neighborId = getWordId(candidate);
+
+				if (neighborId != -1) // If the changed string is a word, it is a neighbor.
+				{
+					adjacencyTargets.push_back(neighborId);
+				}
+			}
+
+			candidate[position] = original; // We restore the character before moving on to the next position.
+		}
+	}
+
+	// The final offset marks the end of the last word's neighbor list.
+	adjacencyOffsets[wordCount] = adjacencyTargets.size();
+}
+
+int WordLadder::comparePatterns(int a, int b, int position) const
+{
+	// Comparing the parts of two words before and after the masked
+	// position is the same as comparing their patterns.
+	//
+	const char* first = getWordData(a);
+	const char* second = getWordData(b);
+
+	int before = memcmp(first, second, position);
+
+	return before != 0 ? before : memcmp(first + position + 1, second + position + 1, wordLength - position - 1);
+}
+
+void WordLadder::sortByPattern(vector<int>& order, int position) const
+{
+	// Packed codes compare in the same order as the words they
+	// hold, and so do their patterns once the masked lane is
+	// cleared, so either comparison gives the same order.
+	//
+	if (packedEngine != nullptr)
+	{
+		PackedCode patternMask = ~getPackedLaneMask(wordLength, position);
+
+		sort(order.begin(), order.end(), [&](int a, int b) { return (wordCodes[a] & patternMask) < (wordCodes[b] & patternMask); });
+	}
+	else
+	{
+		sort(order.begin(), order.end(), [&](int a, int b) { return comparePatterns(a, b, position) < 0; });
+	}
+}
+
+bool WordLadder::isSamePattern(int a, int b, int position) const
+{
+	if (packedEngine != nullptr)
+	{
+		return ((wordCodes[a] ^ wordCodes[b]) & ~getPackedLaneMask(wordLength, position)) == 0;
+	}
+
+	return comparePatterns(a, b, position) == 0;
+}
+
+void WordLadder::buildComponents()
+{
+	// This method labels the connected components with a union-find.
+	// Every word starts off in a set of its own, and each pair of
+	// neighbors merges their sets, so once every pair has been seen,
+	// each set is one component. Merging only needs a few pairs from
+	// each group of neighbors, not every pair, which is why whole
+	// buckets and runs of equal patterns are merged in one pass.
+	//
+	vector<int> parent(wordCount);	// Each word's parent in its set's tree; a root is its own parent
+	vector<int> setSize(wordCount, 1);	// The size of each root's set
+
+	for (int id = 0; id < wordCount; id++)
+	{
+		parent[id] = id;
+	}
+
+	auto findRoot = [&](int id)
+	{
+		while (parent[id] != id)
+		{
+			parent[id] = parent[parent[id]]; // Pointing every other word at its grandparent keeps the trees flat.
+			id = parent[id];
+		}
+
+		return id;
+	};
+
+	auto merge = [&](int a, int b)
+	{
+		a = findRoot(a);
+		b = findRoot(b);
+
+		if (a == b)
+		{
+			return;
+		}
+
+		if (setSize[a] < setSize[b]) // The smaller set goes under the larger, which also keeps the trees flat.
+		{
+			swap(a, b);
+		}
+
+		parent[b] = a;
+		setSize[a] += setSize[b];
+	};
+
+	if ((int)adjacencyOffsets.size() == wordCount + 1) // If we have the graph, we merge along its edges.
+	{
+		for (int id = 0; id < wordCount; id++)
+		{
+			for (int edge = adjacencyOffsets[id]; edge < adjacencyOffsets[id + 1]; edge++)
+			{
+				if (adjacencyTargets[edge] > id) // Each edge is stored both ways, but once is enough.
+				{
+					merge(id, adjacencyTargets[edge]);
+				}
+			}
+		}
+	}
+	else if (!bucketOffsets.empty()) // If we have the buckets, every bucket is merged into its first word.
+	{
+		for (int bucket = 0; bucket + 1 < (int)bucketOffsets.size(); bucket++)
+		{
+			for (int member = bucketOffsets[bucket] + 1; member < bucketOffsets[bucket + 1]; member++)
+			{
+				merge(bucketWords[bucketOffsets[bucket]], bucketWords[member]);
+			}
+		}
+	}
+	else // Otherwise, we find the buckets as buildBuckets does, without keeping them.
+	{
+		vector<int> order(wordCount);
+
+		for (int position = 0; position < wordLength; position++)
+		{
+			for (int id = 0; id < wordCount; id++)
+			{
+				order[id] = id;
+			}
+
+			sortByPattern(order, position);
+
+			for (int i = 1; i < wordCount; i++)
+			{
+				if (isSamePattern(order[i - 1], order[i], position))
+				{
+					merge(order[i - 1], order[i]);
+				}
+			}
+		}
+	}
+
+	// Now we number the components in order of their smallest word,
+	// which is the first word of each one that we come across.
+	wordComponents.assign(wordCount, -1);
+	componentSizes.clear();
+
+	vector<int> rootComponents(wordCount, -1); // The number given to each root's component
+
+	for (int id = 0; id < wordCount; id++)
+	{
+		int root = findRoot(id);
+
+		if (rootComponents[root] == -1)
+		{
+			rootComponents[root] = componentSizes.size();
+			componentSizes.push_back(0);
+		}
+
+		wordComponents[id] = rootComponents[root];
+		componentSizes[wordComponents[id]]++;
+	}
+}
+
+int WordLadder::getComponentCount() const
+{
+	return componentSizes.size();
+}
+
+vector<int> WordLadder::getComponentSizes() const
+{
+	return componentSizes;
+}
+
+int WordLadder::getComponent(const string& word) const
+{
+	int id = getWordId(word);
+
+	return id == -1 ? -1 : wordComponents[id];
+}
+
+void WordLadder::buildBuckets()
+{
+	// This method builds the wildcard buckets. For every position
+	// in a word, we group together all of the words that are equal
+	// everywhere except that position -- the words matching a
+	// pattern like "C*T". Two words are neighbors exactly when they
+	// share a bucket, so a word's neighbors are the other members
+	// of its buckets, and nothing has to be compared at query time.
+	//
+	bucketOffsets.clear();
+	bucketWords.clear();
+	wordBuckets.assign(wordCount * wordLength, -1); // Every (word, position) pair starts off without a bucket.
+
+	vector<int> order(wordCount); // We will sort word IDs by pattern, once for each masked position.
+
+	for (int position = 0; position < wordLength; position++)
+	{
+		for (int id = 0; id < wordCount; id++)
+		{
+			order[id] = id;
+		}
+
+		// We sort the IDs so that words with the same pattern end up next to each other.
+		sortByPattern(order, position);
+
+		// We now walk through the sorted IDs one run of equal patterns at a time.
+		int runStart = 0;
+
+		while (runStart < wordCount)
+		{
+			int runEnd = runStart + 1;
+
+			while (runEnd < wordCount && isSamePattern(order[runStart], order[runEnd], position))
+			{
+				runEnd++;
+			}
+
+			// A pattern that only one word matches gives that word no
+			// neighbors, so there is no point in storing a bucket for it.
+			if (runEnd - runStart > 1)
+			{
+				int bucket = bucketOffsets.size();
+
+				bucketOffsets.push_back(bucketWords.size());
+
+				for (int i = runStart; i < runEnd; i++)
+				{
+					bucketWords.push_back(order[i]);
+					wordBuckets[order[i] * wordLength + position] = bucket;
+				}
+			}
+
+			runStart = runEnd;
+		}
+	}
+
+	// The final offset marks the end of the last bucket.
+	bucketOffsets.push_back(bucketWords.size());
+}
+
+int WordLadder::scanForNeighbors(int id, int first, int count, int* matches) const
+{
+	// This method hands one chunk of the packed lexicon to the
+	// Hamming kernel, which reports the matches by their position
+	// within the chunk, so we shift them back to word IDs. The
+	// word itself is never a match, as it differs in no positions.
+	//
+	// Words packed into codes are compared a whole word at a time
+	// by their engine, and the other kernels never see them.
+	//
+	int matchCount = packedEngine != nullptr ?
+		packedEngine->findDistanceOneCodes(wordCodes.data() + first, count, wordCodes[id], matches) :
+		findDistanceOneWords(getWordData(first), count, wordLength, getWordData(id), matches);
+
+	for (int i = 0; i < matchCount; i++)
+	{
+		matches[i] += first;
+	}
+
+	return matchCount;
+}
+
+double WordLadder::getIndexBuildTime() const
+{
+	// This method simply returns how long the constructor spent
+	// building the neighbor index, so that it can be reported
+	// separately from the time spent answering queries.
+	//
+	return indexBuildTime;
+}
+
+double WordLadder::getLoadTime() const
+{
+	return loadTime;
+}
+
+WordLadder::SearchStatistics WordLadder::getStatistics() const
+{
+	return workspace.statistics;
+}
+
+bool WordLadder::hasStatistics()
+{
+	return WORD_LADDER_STATS != 0;
+}
+
+#if WORD_LADDER_STATS
+// The header can't include chrono, so this helper for the query
+// methods below lives here, rather than in the class.
+static void recordSearch(WordLadder::SearchWorkspace& state, chrono::steady_clock::time_point searchStart, chrono::steady_clock::time_point searchEnd)
+{
+	// This function adds a finished search to the workspace's
+	// statistics. The search ran from searchStart to searchEnd,
+	// and whatever ladders it gave were built from then until now.
+	// Every search counts the words it expands anyway, so we only
+	// have to add those up here, rather than counting them twice.
+	//
+	chrono::duration<double> searchDuration = searchEnd - searchStart;
+	chrono::duration<double> reconstructDuration = chrono::steady_clock::now() - searchEnd;
+
+	state.statistics.dequeuedWords += state.expandedWords;
+	state.statistics.searchSeconds += searchDuration.count();
+	state.statistics.reconstructSeconds += reconstructDuration.count();
+}
+#endif
+
+int WordLadder::getWordId(const string& str) const
+{
+	return getWordId(str.data(), str.length());
+}
+
+int WordLadder::getWordId(const char* text, size_t length) const
+{
+	// This method finds the ID of the given characters, which is
+	// their position in the sorted, packed lexicon. A string of
+	// the wrong length can't be a word at all; otherwise, we
+	// binary search the packed words, comparing them a whole
+	// fixed-width record at a time.
+	//
+	if (length != (size_t)wordLength)
+	{
+		return -1;
+	}
+
+	// With packed words, the search compares codes instead, and
+	// a string that won't pack has characters no word has.
+	if (packedEngine != nullptr)
+	{
+		PackedCode code;
+
+		return packedEngine->encode(text, code) ? packedEngine->findCode(wordCodes.data(), wordCount, code) : -1;
+	}
+
+	int low = 0;			// The search range starts off as every ID,
+	int high = wordCount;	// not including high.
+
+	while (low < high)
+	{
+		int middle = low + (high - low) / 2;
+		int comparison = memcmp(getWordData(middle), text, wordLength);
+
+		if (comparison == 0) // We found the word, so its position is its ID.
+		{
+			return middle;
+		}
+
+		if (comparison < 0) // The middle word comes before our string, so we search the upper half,
+		{
+			low = middle + 1;
+		}
+		else // and otherwise the lower half.
+		{
+			high = middle;
+		}
+	}
+
+	return -1; // The range ran out without finding the string, so it isn't a word.
+}
+
+void WordLadder::sortPackedWords()
+{
+	// This method puts the packed words in sorted order and
+	// removes any duplicates. Moving fixed-width records around
+	// directly isn't something std::sort can do, so we sort a
+	// list of positions instead, then copy the words into a new
+	// buffer in that order, skipping any that repeat.
+	//
+	wordCount = wordLength > 0 ? packedWords.size() / wordLength : 0;
+
+	vector<int> order(wordCount);
+
+	for (int i = 0; i < wordCount; i++)
+	{
+		order[i] = i;
+	}
+
+	sort(order.begin(), order.end(), [&](int a, int b)
+	{
+		return memcmp(getWordData(a), getWordData(b), wordLength) < 0;
+	});
+
+	string sortedWords;
+
+	sortedWords.reserve(packedWords.size());
+
+	for (int i = 0; i < wordCount; i++)
+	{
+		const char* word = getWordData(order[i]);
+
+		// Duplicates end up next to each other, so we only need to
+		// compare each word with the last one we kept.
+		if (sortedWords.empty() || memcmp(sortedWords.data() + sortedWords.size() - wordLength, word, wordLength) != 0)
+		{
+			sortedWords.append(word, wordLength);
+		}
+	}
+
+	packedWords.swap(sortedWords);
+	packedWords.shrink_to_fit(); // Any duplicates we dropped would otherwise leave unused space behind.
+
+	wordCount = wordLength > 0 ? packedWords.size() / wordLength : 0;
+}
+
+const char* WordLadder::getWordData(int id) const
+{
+	// The words are all the same length, so the word with
+	// a given ID starts that many words into the buffer.
+	//
+	return packedWords.data() + (size_t)id * wordLength;
+}
+
+string WordLadder::getWord(int id) const
+{
+	return string(getWordData(id), wordLength);
+}
+
+int WordLadder::getWordLength() const
+{
+	return wordLength;
+}
+
+vector<string> WordLadder::getMinLadder(const string& start, const string& end)
+{
+	// This method answers the query with the workspace kept by
+	// this instance, so that repeated queries reuse its memory.
+	//
+	return getMinLadder(start, end, workspace);
+}
+
+vector<string> WordLadder::getMinLadder(const string& start, const string& end, SearchWorkspace& state) const
+{
+	// This method takes a start word and a end word and finds
+	// the shortest word ladder with the given start and end
+	// words. This method assumes that the start and end words
+	// are of the same length. After checking that both words
+	// are in the lexicon, a breadth-first search algorithm will
+	// find the shortest word ladder (meaning a sequence where every
+	// adjacent word has a hamming distance of one) and will return
+	// the shortest word ladder if one exists.
+	//
+	// We initialize an empty vector that will contain our ladder.
+	vector<string> ladder;
+
+	LADDER_STATS(state.statistics.queries++);
+
+	// If the start word or end word is NOT in the dictionary,
+	// or the start word IS the end word, we won't be able to find
+	// a valid word ladder, so we just return an empty ladder.
+	if (start == end || !isWord(start) || !isWord(end))
+	{
+		return ladder;
+	}
+
+	int startId = getWordId(start);	// We look up the IDs of our start and end words,
+	int endId = getWordId(end);		// so that the search can work with integers instead of strings.
+
+	// Words in different components have no ladder between them, and
+	// we know that without searching, which is just as well, since a
+	// search would have to visit the start's whole component to find out.
+	if (wordComponents[startId] != wordComponents[endId])
+	{
+		return ladder;
+	}
+
+	// We search using the given workspace, so that nothing has to
+	// be allocated for the search itself. If we reach the end word,
+	// we walk the parents back to build the ladder.
+	LADDER_STATS(chrono::steady_clock::time_point searchStart = chrono::steady_clock::now());
+
+	bool foundEnd = breadthFirstSearch(startId, endId, state);
+
+	LADDER_STATS(chrono::steady_clock::time_point searchEnd = chrono::steady_clock::now());
+
+	if (foundEnd)
+	{
+		buildLadder(startId, endId, state, ladder);
+	}
+
+	LADDER_STATS(recordSearch(state, searchStart, searchEnd));
+
+	// At this point, our ladder either holds the shortest word ladder
+	// for the two words, or is empty, as we weren't able to find a
+	// word ladder between the start and end words.
+	return ladder;
+}
+
+bool WordLadder::getMinLadder(int startId, int endId, SearchWorkspace& state, vector<int>& ladder) const
+{
+	// This method is getMinLadder for callers that already have
+	// the IDs of their words. It runs the very same search, but
+	// the ladder goes into the caller's buffer as IDs, so nothing
+	// is allocated once the buffer has room for it.
+	//
+	ladder.clear();
+
+	LADDER_STATS(state.statistics.queries++);
+
+	if (startId < 0 || startId >= wordCount || endId < 0 || endId >= wordCount || startId == endId)
+	{
+		return false;
+	}
+
+	if (wordComponents[startId] != wordComponents[endId])
+	{
+		return false;
+	}
+
+	LADDER_STATS(chrono::steady_clock::time_point searchStart = chrono::steady_clock::now());
+
+	bool foundEnd = breadthFirstSearch(startId, endId, state);
+
+	LADDER_STATS(chrono::steady_clock::time_point searchEnd = chrono::steady_clock::now());
+
+	if (foundEnd)
+	{
+		buildLadder(startId, endId, state, ladder);
+	}
+
+	LADDER_STATS(recordSearch(state, searchStart, searchEnd));
+
+	return foundEnd;
+}
+
+vector<vector<string>> WordLadder::getMinLadders(const string& start, const vector<string>& ends)
+{
+	// Just like getMinLadder, this uses the instance's own workspace.
+	//
+	return getMinLadders(start, ends, workspace);
+}
+
+vector<vector<string>> WordLadder::getMinLadders(const string& start, const vector<string>& ends, SearchWorkspace& state) const
+{
+	// This method answers several queries that share a start word
+	// with a single breadth-first search. Every word the search
+	// visits gets its parent recorded, so once all of the end words
+	// have been reached, each ladder is just a walk back through
+	// the parents of the same search tree.
+	//
+	vector<vector<string>> ladders(ends.size()); // Every ladder starts off empty, meaning no solution.
+
+	LADDER_STATS(state.statistics.queries += ends.size());
+
+	int startId = getWordId(start);
+
+	if (startId == -1) // If the start word isn't a word, none of the ladders exist,
+	{
+		return ladders; // so we can return them all empty.
+	}
+
+	beginSearch(state);
+
+	if ((int)state.targetEpoch.size() < wordCount)
+	{
+		state.targetEpoch.resize(wordCount, 0);
+	}
+
+	// We mark every distinct end word as a target for this epoch, counting
+	// them as we go, so the search knows how many it still has to find.
+	// An end word equal to the start has no ladder, so it isn't a target.
+	int targetCount = 0;
+
+	for (const string& end : ends)
+	{
+		int endId = getWordId(end);
+
+		// An end word outside the start's component can never be reached,
+		// so making it a target would only send the search through the
+		// whole component looking for it.
+		if (endId != -1 && endId != startId && wordComponents[endId] == wordComponents[startId] && state.targetEpoch[endId] != state.epoch)
+		{
+			state.targetEpoch[endId] = state.epoch;
+			targetCount++;
+		}
+	}
+
+	LADDER_STATS(chrono::steady_clock::time_point searchStart = chrono::steady_clock::now());
+
+	searchToTargets(startId, targetCount, state);
+
+	LADDER_STATS(chrono::steady_clock::time_point searchEnd = chrono::steady_clock::now());
+
+	// Now every target the search reached has been visited, so we
+	// build a ladder for each of them from the shared parents.
+	for (unsigned int i = 0; i < ends.size(); i++)
+	{
+		int endId = getWordId(ends[i]);
+
+		if (endId != -1 && endId != startId && state.visitedEpoch[endId] == state.epoch)
+		{
+			buildLadder(startId, endId, state, ladders[i]);
+		}
+	}
+
+	LADDER_STATS(recordSearch(state, searchStart, searchEnd));
+
+	return ladders;
+}
+
+vector<string> WordLadder::getMinLadderBidirectional(const string& start, const string& end)
+{
+	// Just like getMinLadder, this uses the instance's own workspace.
+	//
+	return getMinLadderBidirectional(start, end, workspace);
+}
+
+vector<string> WordLadder::getMinLadderBidirectional(const string& start, const string& end, SearchWorkspace& state) const
+{
+	// This method finds the same kind of ladder as getMinLadder,
+	// with the same checks on the start and end words, but uses
+	// a bidirectional search to do it.
+	//
+	vector<string> ladder;
+
+	LADDER_STATS(state.statistics.queries++);
+
+	if (start == end || !isWord(start) || !isWord(end))
+	{
+		return ladder;
+	}
+
+	int startId = getWordId(start);
+	int endId = getWordId(end);
+
+	if (wordComponents[startId] != wordComponents[endId]) // Just as in getMinLadder, there is nothing to search for.
+	{
+		return ladder;
+	}
+
+	int meetForward;	// These will hold the two ends of the edge
+	int meetBackward;	// where the two searches met.
+
+	LADDER_STATS(chrono::steady_clock::time_point searchStart = chrono::steady_clock::now());
+
+	bool met = bidirectionalSearch(startId, endId, state, meetForward, meetBackward);
+
+	LADDER_STATS(chrono::steady_clock::time_point searchEnd = chrono::steady_clock::now());
+
+	if (met)
+	{
+		buildBidirectionalLadder(meetForward, meetBackward, state, ladder);
+	}
+
+	LADDER_STATS(recordSearch(state, searchStart, searchEnd));
+
+	return ladder;
+}
+
+void WordLadder::beginSearch(SearchWorkspace& state, bool bidirectional) const
+{
+	// This method gets a workspace ready for a new search
+	// over this lexicon's words.
+	//
+	state.begin(wordCount, bidirectional);
+}
+
+void WordLadder::SearchWorkspace::begin(int wordCount, bool bidirectional)
+{
+	// This method gets the workspace ready for a new search.
+	// The vectors are only ever grown, so after the first
+	// search against a lexicon this allocates nothing.
+	//
+	if ((int)visitedEpoch.size() < wordCount)
+	{
+		visitedEpoch.resize(wordCount, 0);
+		parents.resize(wordCount);
+		queue.resize(wordCount);
+	}
+
+	// The backward half is only needed by bidirectional searches,
+	// so plain searches never pay for it.
+	if (bidirectional && (int)backwardVisitedEpoch.size() < wordCount)
+	{
+		backwardVisitedEpoch.resize(wordCount, 0);
+		backwardParents.resize(wordCount);
+		backwardQueue.resize(wordCount);
+	}
+
+	expandedWords = 0;
+
+	// Moving on to a new epoch makes every word unvisited at once,
+	// without touching the visited stamps at all. The only time we
+	// have to clear them is when the epoch counter wraps around,
+	// as old stamps could otherwise match the new epoch.
+	epoch++;
+
+	if (epoch == 0)
+	{
+		fill(visitedEpoch.begin(), visitedEpoch.end(), 0);
+		fill(backwardVisitedEpoch.begin(), backwardVisitedEpoch.end(), 0);
+		fill(targetEpoch.begin(), targetEpoch.end(), 0);
+
+		epoch = 1;
+	}
+}
+
+bool WordLadder::breadthFirstSearch(int startId, int endId, SearchWorkspace& state) const
+{
+	// This method runs the workspace's breadth-first search over
+	// this lexicon, with the neighbors coming from our engine.
+	//
+	return state.breadthFirstSearch(wordCount, startId, endId, [this](int id, auto visit)
+	{
+		forEachNeighbor(id, visit);
+	});
+}
+
+bool WordLadder::bidirectionalSearch(int startId, int endId, SearchWorkspace& state, int& meetForward, int& meetBackward) const
+{
+	// This method runs two breadth-first searches at once, one
+	// forward from the start word and one backward from the end
+	// word. Each round, we expand whichever side has the smaller
+	// frontier by one full level, so the work stays balanced
+	// even when one end of the ladder is much busier than the other.
+	//
+	// The searches stop the first time a word reached by one side
+	// is found to have been visited by the other. That first
+	// meeting is always on a shortest ladder: until then, the two
+	// visited sets were disjoint, so the ladder is longer than the
+	// two search depths combined, and any meeting found while
+	// adding one more level makes it exactly one longer.
+	//
+	beginSearch(state, true);
+
+	int forwardHead = 0;	// The queues work the same way as in breadthFirstSearch,
+	int forwardTail = 0;	// except that we take them one whole level at a time.
+	int backwardHead = 0;
+	int backwardTail = 0;
 
-	if (inputStream.fail()) // If the input straem fails to open,
+	state.queue[forwardTail++] = startId;
+	state.visitedEpoch[startId] = state.epoch;
+	state.parents[startId] = -1;
+
+	state.backwardQueue[backwardTail++] = endId;
+	state.backwardVisitedEpoch[endId] = state.epoch;
+	state.backwardParents[endId] = -1;
+
+	// While both sides still have words left to expand, a meeting is possible.
+	while (forwardHead < forwardTail && backwardHead < backwardTail)
 	{
-		cout << "Unable to open lexicon file.\n"; // we print a message saying we could not open the lexicon file,
+		// We pick the side with the smaller frontier, and set up references
+		// to its half of the workspace along with the other side's visited marks.
+		bool forward = forwardTail - forwardHead <= backwardTail - backwardHead;
 
-		// and exit our application, as there is nothing we can do without a valid lexicon.
-		// NOTE: If this implementation would be used as part of a different program, it would
-		// be much better if on failure, we throw an exception or somehow notify the caller
-		// that an error occurred - blindly exiting the program is usually not a good look
-		// for a constructor like this!
-		//
-		exit(0);
-	}
+		vector<int>& queue = forward ? state.queue : state.backwardQueue;
+		vector<int>& parents = forward ? state.parents : state.backwardParents;
+		vector<unsigned int>& visited = forward ? state.visitedEpoch : state.backwardVisitedEpoch;
+		vector<unsigned int>& otherVisited = forward ? state.backwardVisitedEpoch : state.visitedEpoch;
+		int& head = forward ? forwardHead : backwardHead;
+		int& tail = forward ? forwardTail : backwardTail;
 
-	string word; // We will use this to hold the word we are currently reading from our lexicon file.
+		int levelEnd = tail; // Words added while expanding this level belong to the next one.
+		int meetFrom = -1;
+		int meetTo = -1;
 
-	// While we successfully read another word from the input stream into our word variable...
-	while (inputStream >> word)
-	{
-		if (word.length() == len)	// if the word's length equals the length of the words that will be in our ladder,
+		while (head < levelEnd && meetFrom == -1)
+		{
+			LADDER_STATS(state.statistics.peakQueueSize = max(state.statistics.peakQueueSize, tail - head));
+
+			int qFront = queue[head++];
+			state.expandedWords++;
+
+			forEachNeighbor(qFront, [&](int neighbor)
+			{
+				if (meetFrom != -1)
+				{
+					return;
+				}
+
+				LADDER_STATS(state.statistics.generatedNeighbors++);
+
+				if (visited[neighbor] == state.epoch)
+				{
+					LADDER_STATS(state.statistics.visitedHits++);
+
+					return;
+				}
+
+				if (otherVisited[neighbor] == state.epoch) // The other side has already been here, so the searches meet.
+				{
+					meetFrom = qFront;
+					meetTo = neighbor;
+
+					return;
+				}
+
+				visited[neighbor] = state.epoch;
+				parents[neighbor] = qFront;
+				queue[tail++] = neighbor;
+			});
+		}
+
+		if (meetFrom != -1)
 		{
-			lexicon.insert(word);	// we insert the word into our lexicon.
+			// We hand back the meeting edge with its forward end first,
+			// which depends on the side that found it.
+			meetForward = forward ? meetFrom : meetTo;
+			meetBackward = forward ? meetTo : meetFrom;
+
+			return true;
 		}
 	}
 
-	// We've finished reading all of the words from
-	// the input stream, so we can close it now.
-	inputStream.close();
+	return false; // One side ran out of words without meeting the other, so there is no ladder.
 }
 
-vector<string> WordLadder::getMinLadder(string start, string end)
+vector<string> WordLadder::getMinLadderAStar(const string& start, const string& end)
 {
-	// This method takes a start word and a end word and finds
-	// the shortest word ladder with the given start and end
-	// words. This method assumes that the start and end words
-	// are of the same length. After checking that both words
-	// are in the lexicon, a breadth-first search algorithm will
-	// find the shortest word ladder (meaning a sequence where every
-	// adjacent word has a hamming distance of one) and will return
-	// the shortest word ladder if one exists.
+	// Just like getMinLadder, this uses the instance's own workspace.
+	//
+	return getMinLadderAStar(start, end, workspace);
+}
+
+vector<string> WordLadder::getMinLadderAStar(const string& start, const string& end, SearchWorkspace& state) const
+{
+	// This method finds the same kind of ladder as getMinLadder,
+	// with the same checks on the start and end words, but uses
+	// an A* search to do it.
 	//
-	// We initialize an empty vector that will contain our ladder.
 	vector<string> ladder;
 
-	// If the start word or end word is NOT in the dictionary,
-	// or the start word IS the end word, we won't be able to find
-	// a valid word ladder, so we just return an empty ladder.
+	state.expandedWords = 0; // Queries answered without searching expand nothing.
+
+	LADDER_STATS(state.statistics.queries++);
+
 	if (start == end || !isWord(start) || !isWord(end))
 	{
 		return ladder;
 	}
 
-	vector<string> seenWords;		// We set up a vector to hold all the words we have seen.
-	vector<string> predecessors;	// We setup another to hold the predecessors of all the words we've seen.
-	list<string> queue;				// Finally, we set up a list to use as our queue for our BFS algorithm.
+	int startId = getWordId(start);
+	int endId = getWordId(end);
+
+	if (wordComponents[startId] != wordComponents[endId])
+	{
+		return ladder;
+	}
+
+	LADDER_STATS(chrono::steady_clock::time_point searchStart = chrono::steady_clock::now());
+
+	bool foundEnd = aStarSearch(startId, endId, state);
+
+	LADDER_STATS(chrono::steady_clock::time_point searchEnd = chrono::steady_clock::now());
+
+	if (foundEnd)
+	{
+		buildLadder(startId, endId, state, ladder);
+	}
+
+	LADDER_STATS(recordSearch(state, searchStart, searchEnd));
 
-	queue.push_back(start);			// We start our queue off with the beginning word of our ladder,
-	seenWords.push_back(start);		// as well as the seen words with it as well.
-	predecessors.push_back("");		// Since our starting word doesn't have a predecessor, we make it an empty string.
+	return ladder;
+}
+
+bool WordLadder::aStarSearch(int startId, int endId, SearchWorkspace& state) const
+{
+	// This method performs the A* search. Each word's f-value is
+	// the steps taken to reach it plus its Hamming distance to the
+	// end word, and we always expand a word with the smallest one.
+	//
+	// One step changes one letter, so it moves the distance to the
+	// end by at most one. That makes the heuristic consistent: the
+	// f-value of a neighbor is the f-value of the word it was reached
+	// from, or one or two more. So the f-values we expand never go
+	// down, and every open word's f-value is within two of the one
+	// being expanded. Instead of a heap, then, we keep the open words
+	// in three buckets, one for each f-value modulo 3, and empty the
+	// bucket for the current f-value before moving on to the next.
+	//
+	beginSearch(state);
+
+	if ((int)state.costs.size() < wordCount)
+	{
+		state.costs.resize(wordCount);
+	}
 
-	while (!queue.empty()) // While we still have items in the queue,
+	for (vector<int>& bucket : state.openBuckets)
 	{
-		string qFront = queue.front();	// We grab the first item in the queue,
+		bucket.clear(); // Clearing keeps the buckets' room from the last search.
+	}
+
+	state.visitedEpoch[startId] = state.epoch;
+	state.parents[startId] = -1;
+	state.costs[startId] = 0;
+
+	int fValue = getHammingDistance(startId, endId);
+	int openCount = 1;
 
-		queue.pop_front();				// and pop it off the queue.
+	state.openBuckets[fValue % 3].push_back(startId);
 
-		// We now get all of qFront's neighbors, so we
-		// can check if we have found the ending word
-		// or a word that will lead us there.
-		set<string> neighbors = getNeighbors(qFront);
+	while (openCount > 0)
+	{
+		vector<int>& bucket = state.openBuckets[fValue % 3];
 
-		// We now loop through every neighbor. While we could have
-		// used a for loop with just the string type instead of a
-		// constant string reference, that would have been incredibly
-		// inefficient, as that would result in a useless string
-		// copy for EACH pass of the for loop.
-		for (const string& s : neighbors)
+		if (bucket.empty()) // Every word with this f-value has been expanded, so we move on to the next.
 		{
-			// We first check if we have seen s yet.
-			// If we have, we do not need to do see
-			// if it will take us to the ending word,
-			// as it means we have already checked it
-			// in the past.
-			if (findInVector(seenWords, s) == -1)
-			{
-				if (s == end) // If s is the end word, we've found the end of our ladder!
-				{
-					seenWords.push_back(s);			// We push the s, the word we just saw, to our seen words,
-					predecessors.push_back(qFront); // as well as its predecessor, qFront to our predecessors.
+			fValue++;
 
-					// We get the index of s in our seenWords vector so that we can grab its predecessor.
-					int sIndex = findInVector(seenWords, s);
+			continue;
+		}
 
-					string& sPredecessor = predecessors[sIndex]; // We get the s's predecessor.
+		LADDER_STATS(state.statistics.peakQueueSize = max(state.statistics.peakQueueSize, openCount));
 
-					ladder.push_back(s); // We start the ladder off with s, which will be our ending word.
+		// Taking the most recently added word breaks ties in favor of
+		// the words furthest along, which are the closest to the end.
+		int qFront = bucket.back();
 
-					// While s's predecessor is not our starting word, we
-					// still have words to add to our ladder, excluding the
-					// start word.
-					while (sPredecessor != start)
-					{
-						// We insert s's predecessor at the beginning of the ladder,
-						// as is the earliest word in the ladder so far.
-						ladder.insert(ladder.begin(), sPredecessor);
+		bucket.pop_back();
+		openCount--;
 
-						// We update our index of s in the seenWords vector so we can
-						// get the next predecessor.
-						sIndex = findInVector(seenWords, sPredecessor);
+		// A word whose cost went down after it was added is in the
+		// buckets twice. The copy with the old, larger f-value is out
+		// of date, and is skipped.
+		if (state.costs[qFront] + getHammingDistance(qFront, endId) != fValue)
+		{
+			continue;
+		}
 
-						// We now get s's predecessor so that we can continue.
-						sPredecessor = predecessors[sIndex];
-					}
+		state.expandedWords++;
 
-					// At this point, our ladder contains all of the words
-					// for the word ladder in order, minus the starting word,
-					// so we go ahead and insert it into the beginning of our
-					// ladder.
-					ladder.insert(ladder.begin(), start);
+		int neighborCost = state.costs[qFront] + 1;
+		bool foundEnd = false;
 
-					return ladder; // We've now created the shortest word ladder for the two words, so we return it.
-				}
-				else // s was not our end word,
-				{
-					seenWords.push_back(s);			// so we push the s, the word we just saw, to our seen words,
-					predecessors.push_back(qFront); // as well as its predecessor, qFront to our predecessors.
+		forEachNeighbor(qFront, [&](int neighbor)
+		{
+			if (foundEnd)
+			{
+				return;
+			}
 
-					queue.push_back(s); // Finally, we push s to the back of our queue.
-				}
+			LADDER_STATS(state.statistics.generatedNeighbors++);
+
+			if (state.visitedEpoch[neighbor] == state.epoch && state.costs[neighbor] <= neighborCost)
+			{
+				LADDER_STATS(state.statistics.visitedHits++);
+
+				return; // We already have a way to this word that is at least as short.
+			}
+
+			state.visitedEpoch[neighbor] = state.epoch;
+			state.parents[neighbor] = qFront;
+			state.costs[neighbor] = neighborCost;
+
+			// The end word's f-value is its cost, and qFront, one step
+			// away, has a Hamming distance of one, so the end word has
+			// the same f-value as qFront: the smallest of any open word.
+			// Nothing left could reach it any sooner, so we can stop.
+			if (neighbor == endId)
+			{
+				foundEnd = true;
+
+				return;
 			}
 
+			state.openBuckets[(neighborCost + getHammingDistance(neighbor, endId)) % 3].push_back(neighbor);
+			openCount++;
+		});
+
+		if (foundEnd)
+		{
+			return true;
 		}
 	}
 
-	// At this point, we return an empty ladder, as we weren't
-	// able to find a word ladder between the start and end words.
+	return false; // Every word we could reach was expanded without reaching the end word.
+}
+
+int WordLadder::getHammingDistance(int a, int b) const
+{
+	if (packedEngine != nullptr)
+	{
+		return packedEngine->getDistance(wordCodes[a], wordCodes[b]);
+	}
+
+	const char* first = getWordData(a);
+	const char* second = getWordData(b);
+	int distance = 0;
+
+	for (int i = 0; i < wordLength; i++)
+	{
+		distance += first[i] != second[i];
+	}
+
+	return distance;
+}
+
+void WordLadder::buildBidirectionalLadder(int meetForward, int meetBackward, SearchWorkspace& state, vector<string>& ladder) const
+{
+	// This method joins the two halves of a bidirectional search.
+	// The forward parents lead from the meeting point back to the
+	// start word, so we collect those and reverse them, then the
+	// backward parents lead from the meeting point on to the end
+	// word, so we can append those in the order we walk them.
+	//
+	ladder.clear();
+
+	for (int id = meetForward; id != -1; id = state.parents[id])
+	{
+		ladder.push_back(getWord(id));
+	}
+
+	reverse(ladder.begin(), ladder.end());
+
+	for (int id = meetBackward; id != -1; id = state.backwardParents[id])
+	{
+		ladder.push_back(getWord(id));
+	}
+}
+
+vector<int> WordLadder::getSearchTree(const string& start, SearchWorkspace& state) const
+{
+	// This method runs a breadth-first search that never stops
+	// early, so that every word reachable from the start ends up
+	// in the tree. The tree itself doubles as the visited marks,
+	// since a word has a parent exactly when it has been visited.
+	//
+	vector<int> tree;
+	int startId = getWordId(start);
+
+	if (startId == -1) // If the start word isn't a word, it has no tree at all.
+	{
+		return tree;
+	}
+
+	tree.assign(wordCount, -1);
+	beginSearch(state); // We only need the workspace for its queue.
+
+	LADDER_STATS(chrono::steady_clock::time_point searchStart = chrono::steady_clock::now());
+
+	int head = 0;
+	int tail = 0;
+
+	state.queue[tail++] = startId;
+	tree[startId] = startId; // The root is its own parent, which is how the walk back knows to stop.
+
+	while (head < tail)
+	{
+		LADDER_STATS(state.statistics.peakQueueSize = max(state.statistics.peakQueueSize, tail - head));
+
+		int qFront = state.queue[head++];
+		state.expandedWords++;
+
+		forEachNeighbor(qFront, [&](int neighbor)
+		{
+			LADDER_STATS(state.statistics.generatedNeighbors++);
+
+			if (tree[neighbor] == -1)
+			{
+				tree[neighbor] = qFront;
+				state.queue[tail++] = neighbor;
+			}
+			else
+			{
+				LADDER_STATS(state.statistics.visitedHits++);
+			}
+		});
+	}
+
+	// The tree is the whole result, so there is nothing to rebuild.
+	LADDER_STATS(recordSearch(state, searchStart, chrono::steady_clock::now()));
+
+	return tree;
+}
+
+vector<string> WordLadder::getLadderFromTree(const vector<int>& tree, const string& end) const
+{
+	// Reading a ladder off a tree is the same walk back through
+	// the parents as buildLadder, except that it stops at the root,
+	// which is the one word that is its own parent.
+	//
+	vector<string> ladder;
+	int endId = getWordId(end);
+
+	// Just as in getMinLadder, a word that isn't in the lexicon,
+	// or the start word itself, has no ladder. Neither does a word
+	// the search never reached.
+	if (endId == -1 || endId >= (int)tree.size() || tree[endId] == -1 || tree[endId] == endId)
+	{
+		return ladder;
+	}
+
+	int id = endId;
+
+	for (; tree[id] != id; id = tree[id])
+	{
+		ladder.push_back(getWord(id));
+	}
+
+	ladder.push_back(getWord(id));
+
+	reverse(ladder.begin(), ladder.end());
+
 	return ladder;
 }
 
-void WordLadder::displayResult(vector<string> sequence)
+void WordLadder::searchToTargets(int startId, int targetCount, SearchWorkspace& state) const
+{
+	// This method is the same breadth-first search as
+	// breadthFirstSearch, except that it keeps going until it
+	// has visited every target, rather than stopping at the
+	// first one. The caller has already started the epoch,
+	// since it needed it to mark the targets.
+	//
+	int head = 0;
+	int tail = 0;
+
+	state.queue[tail++] = startId;
+	state.visitedEpoch[startId] = state.epoch;
+	state.parents[startId] = -1;
+
+	while (head < tail && targetCount > 0) // While there are words to expand and targets left to find,
+	{
+		LADDER_STATS(state.statistics.peakQueueSize = max(state.statistics.peakQueueSize, tail - head));
+
+		int qFront = state.queue[head++];
+		state.expandedWords++;
+
+		forEachNeighbor(qFront, [&](int neighbor)
+		{
+			LADDER_STATS(state.statistics.generatedNeighbors++);
+
+			if (state.visitedEpoch[neighbor] == state.epoch)
+			{
+				LADDER_STATS(state.statistics.visitedHits++);
+
+				return;
+			}
+
+			state.visitedEpoch[neighbor] = state.epoch;
+			state.parents[neighbor] = qFront;
+			state.queue[tail++] = neighbor;
+
+			if (state.targetEpoch[neighbor] == state.epoch) // We've reached one more of our targets.
+			{
+				targetCount--;
+			}
+		});
+	}
+}
+
+void WordLadder::buildLadder(int startId, int endId, SearchWorkspace& state, vector<string>& ladder) const
+{
+	// This method rebuilds the ladder found by a search. We walk
+	// back through the parents from the end word to the start word,
+	// appending each word as we go. That gives us the ladder
+	// backwards, so we reverse it once at the end, rather than
+	// inserting every word at the front of the vector.
+	//
+	ladder.clear();
+
+	for (int id = endId; id != startId; id = state.parents[id])
+	{
+		ladder.push_back(getWord(id));
+	}
+
+	ladder.push_back(getWord(startId)); // The start word finishes off the backwards ladder.
+
+	reverse(ladder.begin(), ladder.end());
+}
+
+void WordLadder::buildLadder(int startId, int endId, SearchWorkspace& state, vector<int>& ladder) const
+{
+	// This is the same walk as above, collecting IDs instead of words.
+	//
+	ladder.clear();
+
+	for (int id = endId; id != startId; id = state.parents[id])
+	{
+		ladder.push_back(id);
+	}
+
+	ladder.push_back(startId);
+
+	reverse(ladder.begin(), ladder.end());
+}
+
+string WordLadder::formatResult(const vector<string>& sequence) const
 {
 	// This method simply takes a word ladder sequence,
-	// which is just a vector of strings, and displays
+	// which is just a vector of strings, and describes
 	// the steps taken to transition from the first word
 	// in the ladder to the last word, as well as
-	// outputting the number of steps needed to reach
-	// the final word.
+	// giving the number of steps needed to reach
+	// the final word. The description is returned rather
+	// than printed, so that it can be sent anywhere, like
+	// back to a client of the ladder server.
 	//
 	if (sequence.empty()) // If our sequence is empty,
 	{
-		// we output that there was no solution. This means that
+		// we say that there was no solution. This means that
 		// with the loaded dicionary, there is no way to get between
 		// the beginning word to the ending word, changing only
 		// a single character at a time.
 		//
-		cout << "Word Ladder is empty - No Solution\n";
-
-		return; // We return, as we've already displayed that our ladder was empty.
+		return "Word Ladder is empty - No Solution\n"; // We return, as there is nothing else to describe.
 	}
 
 	if (!isWordLadder(sequence)) // If our sequence isn't a valid word ladder,
 	{
-		// we print out a message stating that we did not pass a valid
+		// we return a message stating that we did not pass a valid
 		// word ladder to display. This is here because we do not want
 		// to display that we have the shortest word ladder when we don't
 		// have a valid word ladder in the first place!
-		cout << "Word Ladder is invalid - the sequence passed in is not a valid word ladder.\n";
-
-		return; // We return, since we aren't going to be displaying the sequence.
+		return "Word Ladder is invalid - the sequence passed in is not a valid word ladder.\n"; // We return, since we aren't going to be describing the sequence.
 	}
 
-	// Since we have a non-empty sequence, we output the required text
+	// Since we have a non-empty sequence, we describe it with the required text
 	// from our lab document, simply stating what the shortest word ladder is,
 	// as well as the steps it takes to get there, which is simply the size of the
 	// sequence minus one, as the beginning word does NOT count as a step.
-	cout << "A Shortest Word Ladder (" << sequence.size() - 1 << " steps) is: ";
+	string result = "A Shortest Word Ladder (" + to_string(sequence.size() - 1) + " steps) is: ";
 
 	// We now need to loop through every item in our sequence so we can print
 	// out each word. While we could use a simple for loop with an index,
@@ -220,118 +1617,144 @@ void WordLadder::displayResult(vector<string> sequence)
 	// after every pass through an item. Once the iterator has reached the end,
 	// we are finished.
 	//
-	for (vector<string>::iterator iterator = sequence.begin(); iterator != sequence.end(); iterator++)
+	for (vector<string>::const_iterator iterator = sequence.begin(); iterator != sequence.end(); iterator++)
 	{
 		// We simply dereference out iterator, which will give us the item in the
-		// sequence at the iterator's position, then output it.
-		cout << *iterator;
+		// sequence at the iterator's position, then add it to the result.
+		result += *iterator;
 
 		// if we haven't reached the last item of our sequence yet,
 		if (iterator != sequence.end() - 1)
 		{
-			cout << " "; // we display a space so that the sequence is properly spaced out.
+			result += " "; // we add a space so that the sequence is properly spaced out.
 		}
 	}
 
-	cout << endl; // Finally, we finish off with a new line since we've displayed our entire sequence.
+	result += "\n"; // Finally, we finish off with a new line since we've described our entire sequence.
+
+	return result;
 }
 
-bool WordLadder::isWord(string str)
+void WordLadder::formatResult(const vector<int>& ladder, string& output) const
 {
-	// This method checks to see if the given string
-	// is a word inside of the WordLadder's dictionary.
-	// If it is, true is returned.
+	// This method describes a ladder of IDs in exactly the same
+	// words as the method above, but appends everything to the
+	// caller's string, which keeps its memory from the last call.
+	// Even the step count is written out by hand, digit by digit,
+	// so that no temporary string is made for it.
 	//
-	// We utilize set::find, which starts from the beginning
-	// of the set and going to the end, looking for the
-	// given string. If set::find is able to find the
-	// string, it will return an iterator located at the
-	// index of the given string inside of the dictionary
-	// set.
-	set<string>::iterator it = lexicon.find(str);
-
-	// At this point, our iterator will either point at
-	// the element in the dictionary, our string, or
-	// the end of the set. If it points to the end of the
-	// set, we were not able to find the given word,
-	// so this will return false. Otherwise, it will
-	// return true, as we found the word.
-	return it != lexicon.end();
-}
-
-int WordLadder::findInVector(vector<string> vec, string str)
-{
-	// This method tries to find the given string inside of
-	// the given vector. If it is found in the vector, the
-	// index of the string is returned. Otherwise, -1 is returned.
-	//
-	// We utilize std::find and start from the beginning
-	// of the vector and go to the end, looking for the
-	// given string. If std::find is able to find the
-	// string, it will return an iterator located at the
-	// index of the given string inside of the vector.
-	vector<string>::iterator it = find(vec.begin(), vec.end(), str);
-
-	// At this point, our iterator will either point at
-	// the element in the vector, our string, or
-	// the end of the set. If it points to the end of the
-	// vector, we were not able to find the given word,
-	// so we return -1. Otherwise, it will
-	// return true, as we found the word.
-	if (it != vec.end())
-	{
-		return distance(vec.begin(), it);
+	output.clear();
+
+	if (ladder.empty())
+	{
+		output += "Word Ladder is empty - No Solution\n";
+
+		return;
 	}
-	else
+
+	// Just like isWordLadder, a ladder needs at least two words,
+	// and every adjacent pair of them must differ in one letter.
+	bool valid = ladder.size() >= 2;
+
+	for (size_t i = 0; valid && i < ladder.size(); i++)
 	{
-		return -1;
+		valid = ladder[i] >= 0 && ladder[i] < wordCount && (i == 0 || getHammingDistance(ladder[i - 1], ladder[i]) == 1);
+	}
+
+	if (!valid)
+	{
+		output += "Word Ladder is invalid - the sequence passed in is not a valid word ladder.\n";
+
+		return;
+	}
+
+	char digits[24];
+	int digitCount = 0;
+
+	for (size_t steps = ladder.size() - 1; steps > 0 || digitCount == 0; steps /= 10)
+	{
+		digits[digitCount++] = (char)('0' + steps % 10);
+	}
+
+	output += "A Shortest Word Ladder (";
+
+	while (digitCount > 0)
+	{
+		output += digits[--digitCount];
+	}
+
+	output += " steps) is: ";
+
+	for (size_t i = 0; i < ladder.size(); i++)
+	{
+		output.append(getWordData(ladder[i]), wordLength);
+		output += i + 1 < ladder.size() ? ' ' : '\n';
 	}
 }
 
-set<string> WordLadder::getNeighbors(string word)
+void WordLadder::displayResult(const vector<string>& sequence)
+{
+	// Displaying a result is just printing its description.
+	//
+	cout << formatResult(sequence);
+}
+
+bool WordLadder::isWord(const string& str) const
+{
+	// This method checks to see if the given string
+	// is a word inside of the WordLadder's dictionary.
+	// If it is, true is returned.
+	//
+	// Finding a word's ID already means searching the
+	// packed lexicon for it, so a string is a word
+	// exactly when it has an ID.
+	return getWordId(str) != -1;
+}
+
+set<string> WordLadder::getNeighbors(const string& word)
 {
 	// This method finds the neighbors of the given
-	// word. Neighbors are found by looping through
-	// each	word inside of the lexicon, checking if
-	// they are a neighbor of the given word,
-	// and adding them to a set of neighbors if so.
+	// word, which are all of the words with a hamming
+	// distance of one from it. They are read straight
+	// out of the neighbor index.
 	//
 	set<string> neighbors; // We start with an empty set of neighbors
 
 	// Before looking for neighbors, we need to ensure
 	// that our word is contained in the lexicon. If it
 	// is not, we shouldn't even bother looking for neighbors,
-	if (!isWord(word))
+	int id = getWordId(word);
+
+	if (id == -1)
 	{
 		return neighbors; // so we return an empty set of neighbors.
 	}
 
-	// We loop through every word inside of our
-	// lexicon. While we could have used a for loop
-	// with just the string type instead of a constant
-	// string reference, that would have been incredibly
-	// inefficient, as that would result in a useless string
-	// copy for EACH pass of the for loop.
-	for (const string& lexiconWord : lexicon)
+	// The neighbor index does the real work, so we only need
+	// to collect each neighbor it gives us.
+	forEachNeighbor(id, [&](int neighbor)
 	{
-		// We check if the hamming distance between the
-		// given word and our lexicon's word is one.
-		// If it is, then the lexicon word only differs
-		// by a single character from the given word,
-		// so it IS a neighbor.
-		if (getHammingDistance(word, lexiconWord) == 1)
-		{
-			// Since we know the lexicon word is a neighbor,
-			// we insert it into our set.
-			neighbors.insert(lexiconWord);
-		}
-	}
+		neighbors.insert(getWord(neighbor));
+	});
 
 	// Now that we've determined all of our neighbors, we simply return them.
 	return neighbors;
 }
 
-int WordLadder::getHammingDistance(string str1, string str2)
+void WordLadder::getNeighbors(int id, vector<int>& neighbors) const
+{
+	// The neighbor index hands us every neighbor's ID, so we
+	// just collect them into the caller's buffer.
+	//
+	neighbors.clear();
+
+	forEachNeighbor(id, [&](int neighbor)
+	{
+		neighbors.push_back(neighbor);
+	});
+}
+
+int WordLadder::getHammingDistance(const string& str1, const string& str2) const
 {
 	// This method takes the two given words, and calculates
 	// their hamming distance (see https://en.wikipedia.org/wiki/Hamming_distance)
@@ -366,7 +1789,7 @@ int WordLadder::getHammingDistance(string str1, string str2)
 	return hammingDistance; // At this point, we've calculated our hamming distance so we just return it.
 }
 
-bool WordLadder::isWordLadder(vector<string> sequence)
+bool WordLadder::isWordLadder(const vector<string>& sequence) const
 {
 	// This method checks the given vector
 	// of strings and determines if it makes
@@ -389,11 +1812,11 @@ bool WordLadder::isWordLadder(vector<string> sequence)
 	// representing the last item in the sequence, and check
 	// each item's hamming distance with the item right after
 	// it.
-	for (vector<string>::iterator iterator = sequence.begin(); iterator != sequence.end() - 1; iterator++)
+	for (vector<string>::const_iterator iterator = sequence.begin(); iterator != sequence.end() - 1; iterator++)
 	{
-		string& word = *iterator;			// We first get the word located at our position in the iterator,
+		const string& word = *iterator;			// We first get the word located at our position in the iterator,
 
-		string& nextWord = *(iterator + 1);	// as well as the word right after the word at our iterator.
+		const string& nextWord = *(iterator + 1);	// as well as the word right after the word at our iterator.
 
 		// We now get the hamming distance between our two words.
 		// If it is not one, then this sequence is NOT a word ladder,
@@ -409,13 +1832,13 @@ bool WordLadder::isWordLadder(vector<string> sequence)
 	return true;
 }
 
-int WordLadder::getWordCount()
+int WordLadder::getWordCount() const
 {
 	// This method simply returns the total number of words
 	// in the lexicon, which can be used to ensure that words
 	// were properly loaded into the dictionary.
 	//
-	// We use set's size method to return the number of items
-	// in the set, which is the number of words in the lexicon.
-	return lexicon.size();
+	// Every word in the packed lexicon is unique, so the
+	// number of words we packed is the size of the lexicon.
+	return wordCount;
 }
\ No newline at end of file
@@ -24,16 +24,220 @@
 
 using namespace std;
 
+struct PackedWordEngine; // See PackedWords.h
+
+// The searches keep query statistics (see SearchStatistics below) unless WORD_LADDER_STATS is defined
+// as 0, say with /DWORD_LADDER_STATS=0. LADDER_STATS wraps every statement that keeps them, so that
+// building without them compiles the counters and timers out of the searches altogether.
+//
+#ifndef WORD_LADDER_STATS
+#define WORD_LADDER_STATS 1
+#endif
+
+#if WORD_LADDER_STATS
+#define LADDER_STATS(...) __VA_ARGS__
+#else
+#define LADDER_STATS(...)
+#endif
+
 class WordLadder
 {
 public:
 
+    //---------------------------------------------------------------------------------------------
+    // The ways a WordLadder can find the neighbors of a word.
+    //
+    // GRAPH_ENGINE    precomputes every word's neighbor list up front. Building it costs the most,
+    //                 but each lookup is a single contiguous read, so it suits many queries against
+    //                 the same lexicon.
+    // BUCKET_ENGINE   files every word of length L under L wildcard patterns ("C*T" holds CAT, COT
+    //                 and CUT), and finds neighbors on demand as the union of the word's L buckets.
+    //                 It is much cheaper to build, so it suits large lexicons and few queries.
+    // SCAN_ENGINE     builds nothing at all, and finds neighbors by scanning the whole lexicon with
+    //                 a vectorized Hamming-distance kernel (see HammingKernel.h). It costs no time
+    //                 or memory up front, so it suits small lexicons and one-off queries.
+    //
+    enum NeighborEngine
+    {
+        GRAPH_ENGINE,
+        BUCKET_ENGINE,
+        SCAN_ENGINE
+    };
+
+
+    //---------------------------------------------------------------------------------------------
+    // The statistics of the queries answered with one workspace, added up over every query since
+    // the workspace was made (or its statistics were reset). Dividing by queries gives the
+    // averages per query. They are only kept if WORD_LADDER_STATS is on; see hasStatistics.
+    //
+    // The counters come from the searches themselves, so queries answered without searching, such
+    // as those between words of different components, count as queries and nothing else. A search
+    // tree built by getSearchTree adds to the counters and the search time, but isn't a query.
+    //
+    struct SearchStatistics
+    {
+        long long queries = 0;              // The queries answered
+        long long dequeuedWords = 0;        // Words taken off a queue (or A* bucket) and expanded
+        long long generatedNeighbors = 0;   // Neighbors handed to the searches by the neighbor index
+        long long visitedHits = 0;          // Neighbors skipped because they had already been visited
+        int peakQueueSize = 0;              // The most words waiting in any one queue at once
+        double searchSeconds = 0;           // Time spent searching
+        double reconstructSeconds = 0;      // Time spent building ladders from the searches' parents
+
+        //-----------------------------------------------------------------------------------------
+        // Adds another workspace's statistics to these, keeping the larger peak queue size.
+        //
+        void add(const SearchStatistics& other)
+        {
+            queries += other.queries;
+            dequeuedWords += other.dequeuedWords;
+            generatedNeighbors += other.generatedNeighbors;
+            visitedHits += other.visitedHits;
+            peakQueueSize = other.peakQueueSize > peakQueueSize ? other.peakQueueSize : peakQueueSize;
+            searchSeconds += other.searchSeconds;
+            reconstructSeconds += other.reconstructSeconds;
+        }
+    };
+
+
+    //---------------------------------------------------------------------------------------------
+    // The state of a breadth-first search, kept between searches so that a search allocates
+    // nothing once the workspace has grown to the size of the lexicon.
+    //
+    // A WordLadder is never changed by a query, so any number of threads can query the same
+    // instance at once, as long as each of them passes in its own workspace.
+    //
+    // Rather than clearing the visited marks before every search, each search gets a new epoch
+    // number, and a word counts as visited only if its stamp equals the current epoch.
+    //
+    struct SearchWorkspace
+    {
+        vector<unsigned int> visitedEpoch;  // The epoch in which each word was last visited
+        vector<int> parents;                // The word each visited word was reached from
+        vector<int> queue;                  // The BFS queue; every word is enqueued at most once
+        unsigned int epoch = 0;             // The epoch of the current search
+
+        // The backward half of a bidirectional search, which runs from the end word. These are
+        // only grown by searches that need them.
+        //
+        vector<unsigned int> backwardVisitedEpoch;
+        vector<int> backwardParents;
+        vector<int> backwardQueue;
+
+        // The epoch in which each word was last marked as one of the targets of a multi-target
+        // search. Only grown by searches that need it.
+        //
+        vector<unsigned int> targetEpoch;
+
+        // The state of an A* search: the number of steps from the start to each visited word, and
+        // the open words, in three buckets by f-value modulo 3. Only grown by searches that need them.
+        //
+        vector<int> costs;
+        vector<int> openBuckets[3];
+
+        int expandedWords = 0;              // The number of words the last search expanded
+
+        SearchStatistics statistics;        // The statistics of every query answered with this workspace
+
+        //-----------------------------------------------------------------------------------------
+        // Gets the workspace ready for a new search over wordCount words: grows the visited marks,
+        // parents and queue to that size (and their backward halves too, for a bidirectional
+        // search), then starts a new epoch, clearing the old marks only if the epoch wraps around.
+        // Any search over the workspace, whoever runs it, starts here.
+        //
+        void begin(int wordCount, bool bidirectional = false);
+
+        //-----------------------------------------------------------------------------------------
+        // Runs a breadth-first search over wordCount words, from startId until endId is reached,
+        // recording the parent of every word it visits. The neighbors come from the caller, through
+        // forEachNeighbor(id, visit), which calls visit(neighborId) for every neighbor of a word,
+        // so WordLadder and EditLadder share the one search over their different neighbor indexes.
+        // Being a template, it is defined below the WordLadder class.
+        //
+        // returns  true if endId was reached, false otherwise
+        //
+        template <typename NeighborSource>
+        bool breadthFirstSearch(int wordCount, int startId, int endId, NeighborSource forEachNeighbor);
+    };
+
     //---------------------------------------------------------------------------------------------
     // Constructor to set up the game -- basically consists of just loading the lexicon (dictionary)
     // 
     // In order to help with efficiency, we keep only the words with the specified length
     // 
-    WordLadder(string lexiconFileName, int len);
+    // The neighbor index for the chosen engine is built here, once, before any query is answered.
+    //
+    // If a snapshot written by writeSnapshot sits next to the lexicon file, and it is intact and
+    // up to date, the words and index are loaded from it instead, which skips both reading the text
+    // and building the index. Otherwise, the text file is loaded as usual.
+    //
+    WordLadder(const string& lexiconFileName, int len, NeighborEngine engine = GRAPH_ENGINE);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Copy constructor -- copies the words, neighbor index and components of another instance,
+    // which takes time and memory in proportion to the lexicon and its index. The workspace isn't
+    // copied: the copy starts with an empty one, and statistics of its own. Assigning one instance
+    // to another isn't allowed.
+    //
+    WordLadder(const WordLadder& other);
+    WordLadder& operator=(const WordLadder&) = delete;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Writes a snapshot of the given lexicon file to the file getSnapshotFileName(lexiconFileName).
+    // The snapshot has one section for every word length in the lexicon, holding its packed words,
+    // adjacency graph and wildcard buckets, so any engine can start without building anything.
+    // Defined in WordLadderSnapshot.cpp, along with the format itself.
+    //
+    // lexiconFileName  the lexicon (dictionary) file to take a snapshot of
+    // returns          the number of sections written, or -1 if the snapshot could not be written
+    //
+    static int writeSnapshot(const string& lexiconFileName);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the name of the snapshot file that goes with the given lexicon file.
+    //
+    static string getSnapshotFileName(const string& lexiconFileName);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns true if this instance was loaded from a snapshot rather than the text lexicon.
+    //
+    bool isLoadedFromSnapshot() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of seconds it took to build the neighbor index for the lexicon, and label
+    // its components. The index is built once in the constructor, so this cost is paid once per
+    // instance rather than once per call to getMinLadder.
+    //
+    // returns  the time spent building the neighbor index, in seconds
+    //
+    double getIndexBuildTime() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of seconds the constructor spent loading the lexicon: reading and sorting
+    // the words, or loading them from a snapshot. The index is timed separately, by
+    // getIndexBuildTime.
+    //
+    double getLoadTime() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the statistics of the queries answered with this instance's own workspace, by the
+    // query methods that don't take one. Queries given a workspace keep their statistics in it.
+    //
+    SearchStatistics getStatistics() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns true if the searches keep statistics, or false if WORD_LADDER_STATS compiled them out,
+    // in which case every statistic stays zero.
+    //
+    static bool hasStatistics();
 
 
     //---------------------------------------------------------------------------------------------
@@ -47,7 +251,226 @@ public:
     // end      the ending word
     // returns  a minimum length word ladder from start to end
     //
-    vector<string> getMinLadder(string start, string end);
+    vector<string> getMinLadder(const string& start, const string& end);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a minimum-length word ladder from start to end, found with a bidirectional
+    // breadth-first search. It follows the same contract as getMinLadder, but searches from both
+    // ends at once, always expanding the smaller of the two frontiers by a full level, and stops
+    // as soon as the two searches meet. On long ladders this visits far fewer words.
+    //
+    // start    the starting word
+    // end      the ending word
+    // returns  a minimum length word ladder from start to end
+    //
+    vector<string> getMinLadderBidirectional(const string& start, const string& end);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a minimum-length word ladder from start to each of the given ends, using a single
+    // breadth-first search tree rooted at start. The search stops as soon as every end that can be
+    // reached has been, so answering many queries that share a start word costs one search.
+    //
+    // start    the starting word
+    // ends     the ending words
+    // returns  the ladders, in the same order as ends; each follows the contract of getMinLadder
+    //
+    vector<vector<string>> getMinLadders(const string& start, const vector<string>& ends);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a minimum-length word ladder from start to end, found with an A* search. It follows
+    // the same contract as getMinLadder.
+    //
+    // The search is guided by the Hamming distance from each word to end, which never overestimates
+    // the steps left, since each step changes a single letter. Words are expanded in order of the
+    // steps taken so far plus that distance, so the search heads towards end rather than spreading
+    // out evenly in every direction like a breadth-first search, while still finding a shortest
+    // ladder. The number of words it expanded is left in the workspace's expandedWords, which can
+    // be compared with that of getMinLadder.
+    //
+    // start    the starting word
+    // end      the ending word
+    // returns  a minimum length word ladder from start to end
+    //
+    vector<string> getMinLadderAStar(const string& start, const string& end);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a minimum-length word ladder from start to end, found with a level-synchronous
+    // breadth-first search spread across several threads. It follows the same contract as
+    // getMinLadder, and is meant for single queries against very large lexicons, where one
+    // thread would take seconds to get through the search.
+    //
+    // Each level of the search is split between the threads. While the frontier is small, the
+    // threads expand it top-down, claiming each newly reached word with an atomic compare-and-swap.
+    // Once the frontier grows to a sizable share of the words still unvisited, they switch to
+    // bottom-up, where each unvisited word looks for any neighbor in the frontier, and they switch
+    // back once it shrinks again. Defined in WordLadderParallel.cpp.
+    //
+    // start        the starting word
+    // end          the ending word
+    // threadCount  the number of threads to search with; 0 uses one per hardware thread
+    // returns      a minimum length word ladder from start to end
+    //
+    vector<string> getMinLadderParallel(const string& start, const string& end, int threadCount = 0) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // The same queries as above, searching with the caller's workspace instead of the instance's
+    // own. These never change the WordLadder, so they are safe to call from several threads at
+    // once, as long as no two threads share a workspace.
+    //
+    vector<string> getMinLadder(const string& start, const string& end, SearchWorkspace& state) const;
+    vector<string> getMinLadderBidirectional(const string& start, const string& end, SearchWorkspace& state) const;
+    vector<string> getMinLadderAStar(const string& start, const string& end, SearchWorkspace& state) const;
+    vector<vector<string>> getMinLadders(const string& start, const vector<string>& ends, SearchWorkspace& state) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Runs a breadth-first search from start over every word it can reach, and returns the whole
+    // search tree, so that the ladder from start to any word can later be read off it with
+    // getLadderFromTree, without searching again.
+    //
+    // The tree holds one entry per word ID: the ID of the word it was reached from, the start
+    // word's own ID for the start word, and -1 for every word that can't be reached.
+    //
+    // start    the starting word, the root of the tree
+    // state    the workspace to search with
+    // returns  the search tree, or an empty tree if start isn't a word
+    //
+    vector<int> getSearchTree(const string& start, SearchWorkspace& state) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the minimum-length word ladder from the root of the given search tree to end, by
+    // following the tree's parents. It follows the same contract as getMinLadder.
+    //
+    // tree     a search tree from getSearchTree
+    // end      the ending word
+    // returns  a minimum length word ladder from the tree's root to end
+    //
+    vector<string> getLadderFromTree(const vector<int>& tree, const string& end) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // The queries below work with word IDs, and write their answers into buffers the caller owns,
+    // instead of building strings. A word's ID is its position in the sorted lexicon, from 0 up to
+    // (but not including) getWordCount(). Each call clears the buffer it is given and fills it in
+    // again, so once the buffers and the workspace have grown to fit the largest answer, a query
+    // makes no heap allocations at all, which the string-based queries above can't promise.
+    //
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the ID of the word spelled by the given characters, or -1 if they don't spell a word.
+    //
+    // text     the characters of the word, which don't have to be followed by a null character
+    // length   the number of characters
+    //
+    int getWordId(const char* text, size_t length) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns a pointer to the characters of the word with the given ID. They are not followed by
+    // a null character -- every word is exactly getWordLength() characters long.
+    //
+    const char* getWordData(int id) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the length of every word in the lexicon.
+    //
+    int getWordLength() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Finds a minimum-length word ladder between two words, just as getMinLadder does, and stores
+    // the IDs of its words, from startId to endId, in ladder. If there is no ladder, ladder is left
+    // empty.
+    //
+    // returns  true if a ladder was found, false otherwise
+    //
+    bool getMinLadder(int startId, int endId, SearchWorkspace& state, vector<int>& ladder) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Stores the IDs of every neighbor of the word with the given ID in neighbors, in the order the
+    // neighbor index lists them.
+    //
+    void getNeighbors(int id, vector<int>& neighbors) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Stores in output exactly the text formatResult would return for the ladder with the given IDs.
+    //
+    void formatResult(const vector<int>& ladder, string& output) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of connected components in the lexicon. Two words are in the same
+    // component exactly when there is a word ladder between them, so every query between words of
+    // different components has no solution, and is answered without searching.
+    //
+    // The components are labelled once, in the constructor, whichever engine is used.
+    //
+    int getComponentCount() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of words in each component, indexed by component number.
+    //
+    vector<int> getComponentSizes() const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of the component holding the given word, from 0 up to (but not including)
+    // getComponentCount(), or -1 if it isn't a word.
+    //
+    int getComponent(const string& word) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Adds a word to the lexicon, patching the packed words, the neighbor index and the components
+    // in place instead of rebuilding them. Only the new word's own neighbors are looked up; the
+    // rest of the index is just shifted along to make room. Defined in WordLadderUpdate.cpp.
+    //
+    // That still makes a change cost O(V + E), for V words and E entries in the index: finding
+    // the neighbors scans every word, the shift renumbers every entry and moves each at most once,
+    // and relabelling the components touches every word. It saves building the index, not going
+    // over it.
+    //
+    // Word IDs are positions in sorted order, so every word after the new one has its ID go up by
+    // one. The patched index lists the same neighbors as a rebuilt one would, though not always in
+    // the same order, so where there are several minimum ladders, the one returned may differ.
+    //
+    // Unlike the queries, this changes the WordLadder, so no query may run on it at the same time.
+    // LiveWordLadder makes its changes to a copy instead, for lexicons that are queried while they
+    // change.
+    //
+    // word     the word to add
+    // returns  true if the word was added, false if it isn't getWordLength() characters long, has
+    //          whitespace in it, or is already in the lexicon
+    //
+    bool addWord(const string& word);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Removes a word from the lexicon, patching everything in place just as addWord does. Every
+    // word after it has its ID go down by one. Defined in WordLadderUpdate.cpp.
+    //
+    // word     the word to remove
+    // returns  true if the word was removed, false if it isn't a word
+    //
+    bool removeWord(const string& word);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of words added or removed since the lexicon was loaded. Anything worked
+    // out from the lexicon and kept, like a search tree from getSearchTree, is only good for as
+    // long as this stays the same. A copy of a WordLadder starts with its original's generation.
+    //
+    unsigned long long getGeneration() const;
 
 
     //---------------------------------------------------------------------------------------------
@@ -55,25 +478,354 @@ public:
     //
     // returns number of words in the lexicon
     //
-    int getWordCount();
+    int getWordCount() const;
 
 
     //---------------------------------------------------------------------------------------------
     //  Used to display the result, whether empty, or a valid WordLadder
     //
-    void displayResult(vector<string> sequence);
+    void displayResult(const vector<string>& sequence);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns exactly the text displayResult prints for the given result, newline included.
+    //
+    string formatResult(const vector<string>& sequence) const;
 
 
 private:
 
-    set<string> lexicon;    // The dictionary
+    // The dictionary, stored as one contiguous buffer of fixed-width words. Every word in the lexicon
+    // has the same length, so the word with ID i is the wordLength characters starting at
+    // packedWords[i * wordLength]. The words are sorted and unique, so a word's ID is its position
+    // in sorted order, and looking one up is a binary search.
+    //
+    string packedWords;
+    int wordCount;                  // The number of words in packedWords
+
+    // The words again, packed five bits to a letter into one integer each, in the same order as
+    // packedWords, along with the engine specialized on wordLength that works with them. Lexicons of
+    // words of up to 12 letters, all A to Z, get these; for any other lexicon, wordCodes is empty,
+    // packedEngine is null, and the words are compared character by character instead.
+    //
+    vector<unsigned long long> wordCodes;
+    const PackedWordEngine* packedEngine;
+
+    NeighborEngine engine;          // Which neighbor index this instance was built with
+    bool loadedFromSnapshot;        // Whether the words and index came from a snapshot
+
+    // The adjacency graph of the lexicon, used by GRAPH_ENGINE and stored in compressed sparse row
+    // (CSR) form. The neighbors of the word with ID i are adjacencyTargets[adjacencyOffsets[i]] up
+    // to (but not including) adjacencyTargets[adjacencyOffsets[i + 1]].
+    //
+    vector<int> adjacencyOffsets;   // Where each word's neighbor list starts in adjacencyTargets
+    vector<int> adjacencyTargets;   // Every word's neighbor list, back to back
+
+    // The wildcard buckets of the lexicon, used by BUCKET_ENGINE. A bucket holds every word that
+    // matches one pattern with a single masked position, and its members are bucketWords[bucketOffsets[b]]
+    // up to (but not including) bucketWords[bucketOffsets[b + 1]]. The bucket that word i falls into
+    // when position p is masked is wordBuckets[i * wordLength + p], or -1 if no other word shares it.
+    //
+    vector<int> bucketOffsets;      // Where each bucket's members start in bucketWords
+    vector<int> bucketWords;        // Every bucket's members, back to back
+    vector<int> wordBuckets;        // The bucket of every (word, masked position) pair
+
+    // The connected components of the lexicon. Components are numbered in order of their smallest
+    // word ID, and every word's component is wordComponents[id].
+    //
+    vector<int> wordComponents;     // The component of every word
+    vector<int> componentSizes;     // The number of words in every component
+
+    int wordLength;                 // The length of every word in the lexicon
+    unsigned long long generation;  // The number of words added or removed since loading
+    double indexBuildTime;          // How long it took to build the neighbor index, in seconds
+    double loadTime;                // How long it took to load the words, in seconds
+
+
+    // A Lexicon holds one WordLadder per word length, which it fills in with words it has already
+    // read, rather than having each of them read the lexicon file again.
+    //
+    friend class Lexicon;
+
+    // A LadderEnumerator searches the lexicon itself, by word ID, to find every minimum ladder.
+    //
+    friend class LadderEnumerator;
+
+    // A LadderAnalyzer searches from every word at once, by word ID, to analyze the whole lexicon.
+    //
+    friend class LadderAnalyzer;
+
+    // The benchmark suite times the lookups below, like isWord and getNeighbors, alongside the
+    // public searches.
+    //
+    friend class LadderBenchmark;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Creates a WordLadder for words of the given length, with no words in it yet. The caller
+    // fills in packedWords, then calls sortPackedWords and buildIndex, just like the public
+    // constructor does. Used by Lexicon and writeSnapshot, which read the lexicon file themselves.
+    //
+    WordLadder(int len, NeighborEngine engine);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Loads the section for wordLength from the given mapped snapshot into packedWords and the
+    // neighbor index our engine searches, if it has one; the other index stays in the file. The
+    // snapshot is only used if it is intact, was taken from a lexicon file of lexiconSize bytes
+    // whose contents hash to lexiconHash (see getFileFingerprint), and has a section for this
+    // length whose index agrees with its word count. Defined in WordLadderSnapshot.cpp.
+    //
+    // returns  true if the section was loaded, false if the text lexicon must be loaded instead
+    //
+    bool loadSnapshot(const char* snapshotData, size_t snapshotSize, long long lexiconSize, unsigned long long lexiconHash);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Checks the header of the given mapped snapshot and lists the word lengths it has sections
+    // for, without checking or loading any of them. Defined in WordLadderSnapshot.cpp.
+    //
+    // lengths  set to the word lengths in the snapshot, in increasing order
+    // returns  true if the snapshot is readable and was taken from a lexicon file of lexiconSize
+    //          bytes, whose contents hash to lexiconHash
+    //
+    static bool readSnapshotLengths(const char* snapshotData, size_t snapshotSize, long long lexiconSize, unsigned long long lexiconHash, vector<int>& lengths);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Maps the given file and works out its size in bytes and a hash of its contents, which a
+    // snapshot records so that it can tell whether the lexicon has changed since, even if its
+    // size hasn't. Defined in WordLadderSnapshot.cpp.
+    //
+    // returns  true if the file could be mapped, false if it can't be opened, or is something
+    //          like a pipe, which has no snapshot
+    //
+    static bool getFileFingerprint(const string& fileName, long long& size, unsigned long long& hash);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Appends every word in the given text to wordsByLength[length of the word], growing
+    // wordsByLength as needed, so that each entry is the packed words of one length, in file order.
+    //
+    static void partitionWords(const char* text, size_t length, vector<string>& wordsByLength);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Appends every word of length wordLength in the given text to packedWords. Words are separated
+    // by whitespace, as they are in a lexicon file.
+    //
+    void readWords(const char* text, size_t length);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Appends every word of length wordLength in the given lexicon file to packedWords, reading it
+    // through an input stream. Used for files that can't be memory-mapped. Exits if the file can't
+    // be opened.
+    //
+    void readWords(const string& lexiconFileName);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns true if the given character separates words in a lexicon file.
+    //
+    static bool isWhitespace(char c);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Sorts the words appended to packedWords and drops any duplicates, so that every word's ID is
+    // its position in sorted order. Called once by the constructor, after the words are read.
+    //
+    void sortPackedWords();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the word with the given ID as a string.
+    //
+    string getWord(int id) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Builds the neighbor index for the selected engine, then labels the components. Called once by
+    // the constructor.
+    //
+    void buildIndex();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Packs every word into wordCodes and picks the engine for wordLength, if the words allow it.
+    // Called by buildIndex, before anything that compares words.
+    //
+    void encodeWords();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Labels the connected components with a union-find over the word graph, using whichever index
+    // is built: the graph's edges, or the members of each bucket. With no index, the words are
+    // sorted by each masked pattern in turn, and each run of equal patterns is merged.
+    //
+    void buildComponents();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Compares the patterns of two words with the given position masked, the way memcmp would.
+    // Two words are neighbors exactly when they have the same pattern for some position.
+    //
+    int comparePatterns(int a, int b, int position) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Sorts the given word IDs by their patterns with the given position masked, comparing packed
+    // codes when the words have them, and comparePatterns otherwise.
+    //
+    void sortByPattern(vector<int>& order, int position) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns true if two words have the same pattern with the given position masked.
+    //
+    bool isSamePattern(int a, int b, int position) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Builds the adjacency graph used by GRAPH_ENGINE.
+    //
+    void buildGraph();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Builds the wildcard buckets used by BUCKET_ENGINE.
+    //
+    void buildBuckets();
+
+
+    //---------------------------------------------------------------------------------------------
+    // Used by SCAN_ENGINE: stores in matches the IDs of the neighbors of the word with the given ID
+    // among the count words starting at ID first, and returns how many there are. The lexicon is
+    // scanned SCAN_CHUNK_SIZE words at a time, so that the matches fit in a buffer on the stack.
+    //
+    int scanForNeighbors(int id, int first, int count, int* matches) const;
+
+    static const int SCAN_CHUNK_SIZE = 512;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Stores in neighbors the IDs of every word that differs from the given characters in exactly
+    // one position, in increasing order, by scanning the whole lexicon. Used by addWord for a word
+    // that isn't in any index yet. Defined in WordLadderUpdate.cpp, as are the methods below.
+    //
+    void scanForNeighbors(const char* word, vector<int>& neighbors) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Patch the adjacency graph for a word just given the ID id, whose neighbors (by their new IDs,
+    // in increasing order) are given, or for the word with the ID id, about to be removed.
+    //
+    void insertIntoGraph(int id, const vector<int>& neighbors);
+    void removeFromGraph(int id);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Patch the wildcard buckets, just as insertIntoGraph and removeFromGraph patch the graph.
+    //
+    void insertIntoBuckets(int id, const vector<int>& neighbors);
+    void removeFromBuckets(int id);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Renumbers the components in wordComponents in order of their smallest word, as
+    // buildComponents numbers them, and counts their sizes again. Any labels below labelCount
+    // will do beforehand.
+    //
+    void renumberComponents(int labelCount);
+
+
+    //---------------------------------------------------------------------------------------------
+    // Calls visit(neighborId) for every neighbor of the word with the given ID, using whichever
+    // index the selected engine built. Being a template, it is defined below the class.
+    //
+    template <typename Visitor>
+    void forEachNeighbor(int id, Visitor visit) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the first neighbor of the word with the given ID for which matches(neighborId) is
+    // true, or -1 if there is none. Also defined below the class.
+    //
+    template <typename Predicate>
+    int findNeighbor(int id, Predicate matches) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the ID of the given string; returns -1 if it is not a word
+    //
+    int getWordId(const string& str) const;
+
+
+    SearchWorkspace workspace;      // The workspace reused by the query methods that don't take one
+
+
+    //---------------------------------------------------------------------------------------------
+    // Prepares the workspace for a new search, growing it to the size of the lexicon if needed
+    // and starting a new epoch.
+    //
+    void beginSearch(SearchWorkspace& state, bool bidirectional = false) const;
 
 
     //---------------------------------------------------------------------------------------------
-    // Returns the location within the vector of the given string; returns -1 if not found
+    // Runs a breadth-first search from startId until endId is reached, recording the parent of
+    // every word it visits in the workspace. The search itself is SearchWorkspace's, handed this
+    // lexicon's neighbors.
     //
+    // returns  true if endId was reached, false otherwise
     //
-    int findInVector(vector<string> vec, string);
+    bool breadthFirstSearch(int startId, int endId, SearchWorkspace& state) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Runs a breadth-first search from startId until targetCount distinct words marked in the
+    // workspace's targetEpoch have been visited, or until everything reachable has been.
+    //
+    void searchToTargets(int startId, int targetCount, SearchWorkspace& state) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Walks the parents recorded by a search back from endId to startId, and stores the words
+    // along the way (or their IDs), in order from start to end, in ladder.
+    //
+    void buildLadder(int startId, int endId, SearchWorkspace& state, vector<string>& ladder) const;
+    void buildLadder(int startId, int endId, SearchWorkspace& state, vector<int>& ladder) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Runs a bidirectional breadth-first search between startId and endId. When the two searches
+    // meet across an edge, that edge's forward and backward ends are stored in meetForward and
+    // meetBackward.
+    //
+    // returns  true if the searches met, false otherwise
+    //
+    bool bidirectionalSearch(int startId, int endId, SearchWorkspace& state, int& meetForward, int& meetBackward) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Joins the two parent chains of a bidirectional search where they met, storing the words from
+    // start to end in ladder.
+    //
+    void buildBidirectionalLadder(int meetForward, int meetBackward, SearchWorkspace& state, vector<string>& ladder) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Runs the A* search for getMinLadderAStar, recording parents in the workspace just as
+    // breadthFirstSearch does, so that buildLadder can rebuild the ladder afterwards.
+    //
+    // returns  true if the end word was reached, false otherwise
+    //
+    bool aStarSearch(int startId, int endId, SearchWorkspace& state) const;
+
+
+    //---------------------------------------------------------------------------------------------
+    // Returns the number of positions at which the words with the given IDs differ.
+    //
+    int getHammingDistance(int a, int b) const;
 
 
     //---------------------------------------------------------------------------------------------
@@ -82,7 +834,7 @@ private:
     // str      the string to check
     // returns  true if str is a word, false otherwise
     // 
-    bool isWord(string str);
+    bool isWord(const string& str) const;
 
 
     //---------------------------------------------------------------------------------------------
@@ -91,7 +843,7 @@ private:
     // sequence   the given sequence of strings
     // returns    true if the given sequence is a valid word ladder, false otherwise
     //
-    bool isWordLadder(vector<string> sequence);
+    bool isWordLadder(const vector<string>& sequence) const;
 
 
     //---------------------------------------------------------------------------------------------
@@ -100,7 +852,7 @@ private:
     // word:     the given word
     // returns:  the neighbors of the given word
     //
-    set<string> getNeighbors(string word);
+    set<string> getNeighbors(const string& word);
 
 
     //---------------------------------------------------------------------------------------------
@@ -113,6 +865,195 @@ private:
     // str2    the second string
     // returns the Hamming distance between str1 and str2 if they are the same length, -1 otherwise
     //
-    int getHammingDistance(string str1, string str2);
+    int getHammingDistance(const string& str1, const string& str2) const;
 
 };
+
+
+//-------------------------------------------------------------------------------------------------
+// The neighbor templates, and the search that takes its neighbors from them, are used by more than
+// one source file, so their definitions live here.
+//
+
+template <typename NeighborSource>
+inline bool WordLadder::SearchWorkspace::breadthFirstSearch(int wordCount, int startId, int endId, NeighborSource forEachNeighbor)
+{
+    // This method performs the breadth-first search used to
+    // find the shortest ladder. Every word we visit has its
+    // parent recorded, so that the ladder can be rebuilt by
+    // walking back from the end word once we find it.
+    //
+    begin(wordCount);
+
+    // Since every word is enqueued at most once, the queue never needs
+    // more room than the number of words, and we can use a plain vector
+    // with a head and a tail index instead of a linked list.
+    int head = 0;
+    int tail = 0;
+
+    queue[tail++] = startId;                // We start our queue off with the beginning word of our ladder,
+    visitedEpoch[startId] = epoch;          // and mark it as visited.
+    parents[startId] = -1;                  // The start word has no parent.
+
+    bool foundEnd = false; // We keep track of whether we have reached the end word yet.
+
+    while (head < tail && !foundEnd) // While we still have items in the queue and haven't found the end word,
+    {
+        LADDER_STATS(statistics.peakQueueSize = tail - head > statistics.peakQueueSize ? tail - head : statistics.peakQueueSize);
+
+        int qFront = queue[head++];     // We grab the first item in the queue and move past it,
+        expandedWords++;                // counting it as one more word expanded.
+
+        // We now visit all of qFront's neighbors, so we can check if we
+        // have found the ending word or a word that will lead us there.
+        forEachNeighbor(qFront, [&](int neighbor)
+        {
+            // Once the end word has been found, there is nothing left to do.
+            if (foundEnd)
+            {
+                return;
+            }
+
+            LADDER_STATS(statistics.generatedNeighbors++);
+
+            // We first check if we have seen the neighbor yet.
+            // If we have, we do not need to do see if it will
+            // take us to the ending word, as it means we have
+            // already checked it in the past.
+            if (visitedEpoch[neighbor] == epoch)
+            {
+                LADDER_STATS(statistics.visitedHits++);
+
+                return;
+            }
+
+            visitedEpoch[neighbor] = epoch;     // We mark the neighbor as visited,
+            parents[neighbor] = qFront;         // and record its parent, qFront.
+
+            if (neighbor == endId) // If the neighbor is the end word, we've found the end of our ladder!
+            {
+                foundEnd = true;
+            }
+            else // The neighbor was not our end word,
+            {
+                queue[tail++] = neighbor; // so we push it to the back of our queue.
+            }
+        });
+    }
+
+    return foundEnd;
+}
+
+template <typename Visitor>
+inline void WordLadder::forEachNeighbor(int id, Visitor visit) const
+{
+    // This method hands every neighbor of the given word to the
+    // visitor, reading them from whichever index was built.
+    //
+    if (engine == BUCKET_ENGINE)
+    {
+        // A word's neighbors are the other members of its buckets. Since
+        // two different words can only share a bucket for the one position
+        // they differ in, no neighbor is ever visited twice.
+        for (int position = 0; position < wordLength; position++)
+        {
+            int bucket = wordBuckets[id * wordLength + position];
+
+            if (bucket == -1) // No other word matches this pattern,
+            {
+                continue; // so there is nothing to visit.
+            }
+
+            for (int offset = bucketOffsets[bucket]; offset < bucketOffsets[bucket + 1]; offset++)
+            {
+                if (bucketWords[offset] != id) // The word is a member of its own buckets, but not its own neighbor.
+                {
+                    visit(bucketWords[offset]);
+                }
+            }
+        }
+    }
+    else if (engine == SCAN_ENGINE)
+    {
+        // Without an index, we scan the lexicon one chunk at a time.
+        int matches[SCAN_CHUNK_SIZE];
+
+        for (int first = 0; first < wordCount; first += SCAN_CHUNK_SIZE)
+        {
+            int count = wordCount - first < SCAN_CHUNK_SIZE ? wordCount - first : SCAN_CHUNK_SIZE;
+            int matchCount = scanForNeighbors(id, first, count, matches);
+
+            for (int i = 0; i < matchCount; i++)
+            {
+                visit(matches[i]);
+            }
+        }
+    }
+    else
+    {
+        // With the adjacency graph, the neighbors are already listed back to back.
+        for (int offset = adjacencyOffsets[id]; offset < adjacencyOffsets[id + 1]; offset++)
+        {
+            visit(adjacencyTargets[offset]);
+        }
+    }
+}
+
+template <typename Predicate>
+inline int WordLadder::findNeighbor(int id, Predicate matches) const
+{
+    // This method is forEachNeighbor for searches that only need
+    // one neighbor: it stops at the first neighbor that matches,
+    // instead of visiting the rest.
+    //
+    if (engine == BUCKET_ENGINE)
+    {
+        for (int position = 0; position < wordLength; position++)
+        {
+            int bucket = wordBuckets[id * wordLength + position];
+
+            if (bucket == -1)
+            {
+                continue;
+            }
+
+            for (int offset = bucketOffsets[bucket]; offset < bucketOffsets[bucket + 1]; offset++)
+            {
+                if (bucketWords[offset] != id && matches(bucketWords[offset]))
+                {
+                    return bucketWords[offset];
+                }
+            }
+        }
+    }
+    else if (engine == SCAN_ENGINE)
+    {
+        int scanned[SCAN_CHUNK_SIZE];
+
+        for (int first = 0; first < wordCount; first += SCAN_CHUNK_SIZE)
+        {
+            int count = wordCount - first < SCAN_CHUNK_SIZE ? wordCount - first : SCAN_CHUNK_SIZE;
+            int matchCount = scanForNeighbors(id, first, count, scanned);
+
+            for (int i = 0; i < matchCount; i++)
+            {
+                if (matches(scanned[i]))
+                {
+                    return scanned[i];
+                }
+            }
+        }
+    }
+    else
+    {
+        for (int offset = adjacencyOffsets[id]; offset < adjacencyOffsets[id + 1]; offset++)
+        {
+            if (matches(adjacencyTargets[offset]))
+            {
+                return adjacencyTargets[offset];
+            }
+        }
+    }
+
+    return -1; // None of the neighbors matched.
+}
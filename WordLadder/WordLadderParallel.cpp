@@ -0,0 +1,315 @@
+//==============================================================================================
+// File: WordLadderParallel.cpp - Parallel breadth-first search for word ladders
+// c.f.: WordLadder.h
+//
+// This file implements WordLadder::getMinLadderParallel, a breadth-first
+// search that expands each level of the search across several threads.
+// It is kept apart from WordLadder.cpp since it is the only part of the
+// class that needs threads and atomics.
+//
+// The search is direction-optimizing: small frontiers are expanded
+// top-down, where each frontier word pushes out to its neighbors, and
+// large frontiers bottom-up, where each unvisited word checks whether
+// any of its neighbors are in the frontier. Bottom-up levels stop
+// checking a word as soon as one frontier neighbor turns up, which
+// saves most of the work once the frontier covers a good part of the
+// lexicon.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "WordLadder.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Switch to bottom-up once the frontier holds more than 1/TOP_DOWN_LIMIT of
+// the unvisited words, and back to top-down once it falls below
+// 1/BOTTOM_UP_LIMIT of all the words. These are the ratios suggested by
+// Beamer et al. for direction-optimizing breadth-first search.
+const int TOP_DOWN_LIMIT = 14;
+const int BOTTOM_UP_LIMIT = 24;
+
+// Top-down threads claim frontier words in chunks of this many, so that
+// they don't fight over a shared counter for every single word.
+const int FRONTIER_CHUNK = 256;
+
+namespace
+{
+	//==========================================================================================
+	// A reusable barrier: every thread that calls wait blocks until all of
+	// them have, and then they are all released together. The standard
+	// library only gained one in C++20, so we build it from a mutex and
+	// a condition variable.
+	//
+	class LevelBarrier
+	{
+	public:
+
+		LevelBarrier(int threadCount) : threadCount(threadCount), waiting(0), generation(0)
+		{
+		}
+
+		void wait()
+		{
+			unique_lock<mutex> lock(barrierLock);
+
+			unsigned int arrivedIn = generation;
+
+			if (++waiting == threadCount) // The last thread to arrive releases everyone,
+			{
+				waiting = 0;
+				generation++;
+
+				released.notify_all();
+			}
+			else // while everyone else waits for the generation to move on.
+			{
+				released.wait(lock, [&] { return generation != arrivedIn; });
+			}
+		}
+
+	private:
+
+		mutex barrierLock;
+		condition_variable released;
+		int threadCount;
+		int waiting;
+		unsigned int generation;
+	};
+}
+
+vector<string> WordLadder::getMinLadderParallel(const string& start, const string& end, int threadCount) const
+{
+	// This method runs the level-synchronous search. The calling
+	// thread takes part as thread zero, and between levels it alone
+	// gathers the next frontier and decides which direction to
+	// expand it in, while the others wait at the barrier.
+	//
+	vector<string> ladder;
+
+	if (start == end || !isWord(start) || !isWord(end))
+	{
+		return ladder;
+	}
+
+	int startId = getWordId(start);
+	int endId = getWordId(end);
+
+	if (wordComponents[startId] != wordComponents[endId]) // There's no ladder to find, so no threads need to start.
+	{
+		return ladder;
+	}
+
+	if (threadCount <= 0)
+	{
+		threadCount = thread::hardware_concurrency();
+
+		if (threadCount <= 0)
+		{
+			threadCount = 1;
+		}
+	}
+
+	// Every word's parent, or -1 if it hasn't been reached yet. Threads
+	// claim a word by swapping its parent from -1, so only one of them
+	// ever records it. The start word is its own parent.
+	vector<atomic<int>> parents(wordCount);
+
+	for (int id = 0; id < wordCount; id++)
+	{
+		parents[id].store(-1, memory_order_relaxed);
+	}
+
+	parents[startId].store(startId, memory_order_relaxed);
+
+	vector<int> frontier(1, startId);			// The words in the level being expanded
+	vector<char> inFrontier(wordCount, 0);		// Marks the frontier's words, for bottom-up levels
+	vector<vector<int>> nextParts(threadCount);	// The words each thread reached, which make up the next level
+
+	bool bottomUp = false;				// Which direction the current level is expanded in
+	bool done = false;					// Set once the end word is reached or the search runs dry
+	int unvisitedCount = wordCount - 1;	// How many words haven't been reached yet
+	atomic<int> nextChunk(0);			// The next chunk of the frontier for a top-down thread to claim
+	atomic<bool> foundEnd(false);
+
+	LevelBarrier barrier(threadCount);
+
+	// This expands one thread's share of the current level.
+	auto expandLevel = [&](int threadIndex)
+	{
+		vector<int>& next = nextParts[threadIndex];
+
+		if (bottomUp)
+		{
+			// Each thread owns a fixed slice of the words, so the parent of
+			// an unvisited word is only ever written by one thread, and no
+			// atomic swap is needed.
+			int sliceStart = (long long)wordCount * threadIndex / threadCount;
+			int sliceEnd = (long long)wordCount * (threadIndex + 1) / threadCount;
+
+			for (int id = sliceStart; id < sliceEnd; id++)
+			{
+				if (parents[id].load(memory_order_relaxed) != -1)
+				{
+					continue;
+				}
+
+				int parent = findNeighbor(id, [&](int neighbor) { return inFrontier[neighbor] != 0; });
+
+				if (parent != -1)
+				{
+					parents[id].store(parent, memory_order_relaxed);
+					next.push_back(id);
+
+					if (id == endId)
+					{
+						foundEnd.store(true, memory_order_relaxed);
+					}
+				}
+			}
+		}
+		else
+		{
+			int frontierSize = frontier.size();
+			int chunk;
+
+			while ((chunk = nextChunk.fetch_add(FRONTIER_CHUNK, memory_order_relaxed)) < frontierSize)
+			{
+				int chunkEnd = min(chunk + FRONTIER_CHUNK, frontierSize);
+
+				for (int i = chunk; i < chunkEnd; i++)
+				{
+					int word = frontier[i];
+
+					forEachNeighbor(word, [&](int neighbor)
+					{
+						int unclaimed = -1;
+
+						// A cheap load first skips the swap for words that are
+						// already taken, which is most of them on later levels.
+						if (parents[neighbor].load(memory_order_relaxed) == -1
+							&& parents[neighbor].compare_exchange_strong(unclaimed, word, memory_order_relaxed))
+						{
+							next.push_back(neighbor);
+
+							if (neighbor == endId)
+							{
+								foundEnd.store(true, memory_order_relaxed);
+							}
+						}
+					});
+				}
+			}
+		}
+	};
+
+	// This gathers the next level once every thread has finished the
+	// current one, and picks the direction to expand it in. Only thread
+	// zero runs it, while the others are held at the barrier.
+	auto prepareNextLevel = [&]()
+	{
+		if (bottomUp)
+		{
+			for (int id : frontier)
+			{
+				inFrontier[id] = 0;
+			}
+		}
+
+		frontier.clear();
+
+		for (vector<int>& part : nextParts)
+		{
+			frontier.insert(frontier.end(), part.begin(), part.end());
+			part.clear();
+		}
+
+		unvisitedCount -= frontier.size();
+
+		if (foundEnd.load(memory_order_relaxed) || frontier.empty())
+		{
+			done = true;
+
+			return;
+		}
+
+		int frontierSize = frontier.size();
+
+		if (!bottomUp && frontierSize > unvisitedCount / TOP_DOWN_LIMIT)
+		{
+			bottomUp = true;
+		}
+		else if (bottomUp && frontierSize < wordCount / BOTTOM_UP_LIMIT)
+		{
+			bottomUp = false;
+		}
+
+		if (bottomUp)
+		{
+			for (int id : frontier)
+			{
+				inFrontier[id] = 1;
+			}
+		}
+
+		nextChunk.store(0, memory_order_relaxed);
+	};
+
+	// Every thread runs the same loop: wait for the level to be ready,
+	// expand its share, and wait for the others to finish theirs. The
+	// barriers also make each level's writes visible to the next one.
+	auto runThread = [&](int threadIndex)
+	{
+		while (true)
+		{
+			barrier.wait();
+
+			if (done)
+			{
+				return;
+			}
+
+			expandLevel(threadIndex);
+
+			barrier.wait();
+
+			if (threadIndex == 0)
+			{
+				prepareNextLevel();
+			}
+		}
+	};
+
+	vector<thread> helpers;
+
+	for (int i = 1; i < threadCount; i++)
+	{
+		helpers.push_back(thread(runThread, i));
+	}
+
+	runThread(0);
+
+	for (thread& helper : helpers)
+	{
+		helper.join();
+	}
+
+	if (foundEnd.load(memory_order_relaxed))
+	{
+		// Every parent lies one level closer to the start, so walking
+		// them back gives a shortest ladder, backwards.
+		for (int id = endId; id != startId; id = parents[id].load(memory_order_relaxed))
+		{
+			ladder.push_back(getWord(id));
+		}
+
+		ladder.push_back(start);
+
+		reverse(ladder.begin(), ladder.end());
+	}
+
+	return ladder;
+}
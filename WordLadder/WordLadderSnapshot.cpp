@@ -0,0 +1,502 @@
+//==============================================================================================
+// File: WordLadderSnapshot.cpp - Prebuilt binary snapshots of a lexicon and its indexes
+// c.f.: WordLadder.h
+//
+// Loading a lexicon means reading its text, sorting its words and building a neighbor index,
+// every time a process starts. A snapshot does all of that ahead of time: it stores the sorted
+// words of every length, along with their adjacency graph and wildcard buckets, in a binary file
+// next to the lexicon, which the constructor maps and copies straight into place.
+//
+// The snapshot file is laid out as follows. Every number is stored in the byte order of the
+// machine that wrote it, which the header records, and a snapshot written with a different byte
+// order is simply not used.
+//
+//   Header (40 bytes)
+//     char[8]   magic, "WLSNAP" padded with zeros
+//     uint32    byte order marker, 0x01020304
+//     uint32    format version, SNAPSHOT_VERSION
+//     uint64    size in bytes of the lexicon file the snapshot was taken from
+//     uint64    checksum of the whole lexicon file, so that an edit that keeps its size is caught
+//     uint32    number of sections
+//     uint32    reserved, zero
+//
+//   Section table (32 bytes per section, one section per word length, in increasing length)
+//     uint32    word length
+//     uint32    word count
+//     uint64    offset of the section's payload from the start of the file
+//     uint64    size in bytes of the section's payload
+//     uint64    checksum of the section's payload
+//
+//   Section payload, made of six blocks in this order:
+//     the packed words, the adjacency offsets and targets, the bucket offsets and words,
+//     and the bucket of each word at each position. Each block is a uint64 byte count,
+//     followed by that many bytes, padded with zeros to a multiple of 8 bytes. The index
+//     blocks hold 32-bit ints, exactly as the WordLadder keeps them in memory.
+//
+// A loader only copies the words and the index blocks its engine searches -- the graph for
+// GRAPH_ENGINE, the buckets for BUCKET_ENGINE, and neither for SCAN_ENGINE -- and only if those
+// blocks agree with the section's word count: one adjacency offset per word plus one, one bucket
+// per word and position, and offsets and members that stay within the blocks they point into.
+// Otherwise a file with a valid checksum could still send a search out of bounds.
+//
+// There is no separate table of word IDs: a word's ID is its position in the sorted packed words,
+// which is exactly the ID every index block refers to.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "WordLadder.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	const char SNAPSHOT_MAGIC[8] = { 'W', 'L', 'S', 'N', 'A', 'P', 0, 0 };
+	const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+	const uint32_t SNAPSHOT_VERSION = 2;
+	const int SNAPSHOT_BLOCK_COUNT = 6;
+
+	struct SnapshotHeader
+	{
+		char magic[8];
+		uint32_t byteOrder;
+		uint32_t version;
+		uint64_t sourceSize;
+		uint64_t sourceChecksum;
+		uint32_t sectionCount;
+		uint32_t reserved;
+	};
+
+	struct SnapshotSection
+	{
+		uint32_t wordLength;
+		uint32_t wordCount;
+		uint64_t offset;
+		uint64_t size;
+		uint64_t checksum;
+	};
+
+	uint64_t getChecksum(const char* data, size_t size)
+	{
+		// This is FNV-1a, fed eight bytes at a time rather than one,
+		// which keeps it fast enough to check hundreds of megabytes
+		// at startup while still catching truncated or damaged files.
+		//
+		uint64_t hash = 14695981039346656037ULL;
+		size_t i = 0;
+
+		for (; i + 8 <= size; i += 8)
+		{
+			uint64_t block;
+
+			memcpy(&block, data + i, 8);
+
+			hash = (hash ^ block) * 1099511628211ULL;
+			hash ^= hash >> 29;
+		}
+
+		for (; i < size; i++)
+		{
+			hash = (hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+		}
+
+		return hash;
+	}
+
+	bool readHeader(const char* snapshotData, size_t snapshotSize, long long lexiconSize, uint64_t lexiconChecksum, SnapshotHeader& header)
+	{
+		// This checks everything about the snapshot that doesn't
+		// depend on which section we want: that it is a snapshot we
+		// can read, that it was taken from the lexicon as it is now,
+		// and that its section table fits in the file.
+		//
+		if (snapshotData == nullptr || snapshotSize < sizeof(SnapshotHeader))
+		{
+			return false;
+		}
+
+		memcpy(&header, snapshotData, sizeof(header));
+
+		if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header.byteOrder != SNAPSHOT_BYTE_ORDER || header.version != SNAPSHOT_VERSION)
+		{
+			return false; // It isn't a snapshot, or it's one we can't read.
+		}
+
+		// If the lexicon's size or contents have changed since the snapshot
+		// was taken, the snapshot is out of date, and must not be used.
+		if (lexiconSize < 0 || (uint64_t)lexiconSize != header.sourceSize || lexiconChecksum != header.sourceChecksum)
+		{
+			return false;
+		}
+
+		return header.sectionCount <= (snapshotSize - sizeof(header)) / sizeof(SnapshotSection);
+	}
+
+	SnapshotSection getSection(const char* snapshotData, uint32_t index)
+	{
+		SnapshotSection section;
+
+		memcpy(&section, snapshotData + sizeof(SnapshotHeader) + index * sizeof(SnapshotSection), sizeof(section));
+
+		return section;
+	}
+
+	void appendBlock(string& payload, const void* data, size_t size)
+	{
+		// Each block is its byte count followed by its bytes, padded
+		// so that the next block starts on an 8-byte boundary.
+		//
+		uint64_t byteCount = size;
+
+		payload.append((const char*)&byteCount, sizeof(byteCount));
+		payload.append((const char*)data, size);
+		payload.append((8 - size % 8) % 8, '\0');
+	}
+
+	bool readBlock(const char*& position, const char* end, const char*& data, size_t& size)
+	{
+		// This reads the block at position, checking that it fits in
+		// what's left of the section, and moves past it.
+		//
+		uint64_t byteCount;
+
+		if (end - position < (ptrdiff_t)sizeof(byteCount))
+		{
+			return false;
+		}
+
+		memcpy(&byteCount, position, sizeof(byteCount));
+		position += sizeof(byteCount);
+
+		uint64_t paddedCount = byteCount + (8 - byteCount % 8) % 8;
+
+		if (byteCount > (uint64_t)(end - position) || paddedCount > (uint64_t)(end - position))
+		{
+			return false;
+		}
+
+		data = position;
+		size = (size_t)byteCount;
+		position += paddedCount;
+
+		return true;
+	}
+
+	bool copyIntBlock(const char* data, size_t size, vector<int>& values)
+	{
+		// Index blocks hold whole ints, so anything else means the block is damaged.
+		//
+		if (size % sizeof(int) != 0)
+		{
+			return false;
+		}
+
+		values.resize(size / sizeof(int));
+
+		if (size > 0)
+		{
+			memcpy(values.data(), data, size);
+		}
+
+		return true;
+	}
+
+	bool isCsrConsistent(const vector<int>& offsets, size_t listCount, const vector<int>& members, int memberLimit)
+	{
+		// This checks one compressed index: listCount lists, whose
+		// offsets start at zero, never go backwards, and end exactly
+		// at the end of members, every one of which is below memberLimit.
+		//
+		if (offsets.size() != listCount + 1 || offsets[0] != 0 || offsets[listCount] != (int)members.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < listCount; i++)
+		{
+			if (offsets[i] > offsets[i + 1])
+			{
+				return false;
+			}
+		}
+
+		for (int member : members)
+		{
+			if (member < 0 || member >= memberLimit)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+string WordLadder::getSnapshotFileName(const string& lexiconFileName)
+{
+	return lexiconFileName + ".snapshot";
+}
+
+bool WordLadder::isLoadedFromSnapshot() const
+{
+	return loadedFromSnapshot;
+}
+
+bool WordLadder::getFileFingerprint(const string& fileName, long long& size, unsigned long long& hash)
+{
+	// The snapshot's own checksum is quick enough to run over the
+	// whole lexicon at startup, so we use the same one here.
+	//
+	MappedFile file;
+
+	if (!file.open(fileName))
+	{
+		return false;
+	}
+
+	size = (long long)file.getSize();
+	hash = getChecksum(file.getData(), file.getSize());
+
+	return true;
+}
+
+bool WordLadder::readSnapshotLengths(const char* snapshotData, size_t snapshotSize, long long lexiconSize, unsigned long long lexiconHash, vector<int>& lengths)
+{
+	SnapshotHeader header;
+
+	lengths.clear();
+
+	if (!readHeader(snapshotData, snapshotSize, lexiconSize, lexiconHash, header))
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header.sectionCount; i++)
+	{
+		lengths.push_back((int)getSection(snapshotData, i).wordLength);
+	}
+
+	return true;
+}
+
+bool WordLadder::loadSnapshot(const char* snapshotData, size_t snapshotSize, long long lexiconSize, unsigned long long lexiconHash)
+{
+	// This method tries to load the section for our word length from
+	// the snapshot. Any problem at all with the snapshot just means
+	// we return false and the lexicon is read from its text instead,
+	// so we check everything before trusting a single byte of it.
+	//
+	SnapshotHeader header;
+
+	if (!readHeader(snapshotData, snapshotSize, lexiconSize, lexiconHash, header))
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header.sectionCount; i++)
+	{
+		SnapshotSection section = getSection(snapshotData, i);
+
+		if (section.wordLength != (uint32_t)wordLength)
+		{
+			continue;
+		}
+
+		if (section.offset > snapshotSize || section.size > snapshotSize - section.offset)
+		{
+			return false;
+		}
+
+		const char* position = snapshotData + section.offset;
+		const char* end = position + section.size;
+
+		if (getChecksum(position, (size_t)section.size) != section.checksum)
+		{
+			return false;
+		}
+
+		const char* blocks[SNAPSHOT_BLOCK_COUNT];
+		size_t blockSizes[SNAPSHOT_BLOCK_COUNT];
+
+		for (int block = 0; block < SNAPSHOT_BLOCK_COUNT; block++)
+		{
+			if (!readBlock(position, end, blocks[block], blockSizes[block]))
+			{
+				return false;
+			}
+		}
+
+		if (blockSizes[0] != (size_t)section.wordCount * wordLength)
+		{
+			return false;
+		}
+
+		// The mapping goes away when we return, so we copy the words,
+		// and only the index our engine searches, into the buffers that
+		// will hold them from now on. The other index is left behind in
+		// the file, where it costs nothing.
+		packedWords.assign(blocks[0], blockSizes[0]);
+		wordCount = section.wordCount;
+
+		// The checksum only shows that the section is the one that was
+		// written, so before the searches trust the index, we check that
+		// every offset and ID in it stays inside the arrays it refers to.
+		bool consistent = true;
+
+		if (engine == GRAPH_ENGINE)
+		{
+			consistent = copyIntBlock(blocks[1], blockSizes[1], adjacencyOffsets) && copyIntBlock(blocks[2], blockSizes[2], adjacencyTargets) &&
+				isCsrConsistent(adjacencyOffsets, wordCount, adjacencyTargets, wordCount);
+		}
+		else if (engine == BUCKET_ENGINE)
+		{
+			consistent = copyIntBlock(blocks[3], blockSizes[3], bucketOffsets) && copyIntBlock(blocks[4], blockSizes[4], bucketWords) &&
+				copyIntBlock(blocks[5], blockSizes[5], wordBuckets) && !bucketOffsets.empty() && wordBuckets.size() == (size_t)wordCount * wordLength &&
+				isCsrConsistent(bucketOffsets, bucketOffsets.size() - 1, bucketWords, wordCount);
+
+			int bucketCount = bucketOffsets.empty() ? 0 : (int)bucketOffsets.size() - 1;
+
+			for (size_t i = 0; consistent && i < wordBuckets.size(); i++)
+			{
+				consistent = wordBuckets[i] >= -1 && wordBuckets[i] < bucketCount;
+			}
+		}
+
+		if (!consistent)
+		{
+			packedWords.clear();
+			adjacencyOffsets.clear();
+			adjacencyTargets.clear();
+			bucketOffsets.clear();
+			bucketWords.clear();
+			wordBuckets.clear();
+			wordCount = 0;
+
+			return false;
+		}
+
+		return true;
+	}
+
+	return false; // The snapshot has no words of our length.
+}
+
+int WordLadder::writeSnapshot(const string& lexiconFileName)
+{
+	// This method takes a snapshot of the whole lexicon. We read
+	// the lexicon once, splitting its words up by length, then
+	// build both indexes for each length, and write it all out as
+	// one section per length.
+	//
+	MappedFile lexiconFile;
+
+	if (!lexiconFile.open(lexiconFileName))
+	{
+		cout << "Unable to open lexicon file.\n";
+
+		return -1;
+	}
+
+	// The header records the lexicon's size and checksum, taken from
+	// the very bytes the words are read from, so a loader can tell
+	// when the lexicon no longer matches the snapshot.
+	long long lexiconSize = (long long)lexiconFile.getSize();
+	uint64_t lexiconChecksum = getChecksum(lexiconFile.getData(), lexiconFile.getSize());
+	vector<string> wordsByLength;
+
+	partitionWords(lexiconFile.getData(), lexiconFile.getSize(), wordsByLength);
+
+	lexiconFile.close();
+
+	vector<SnapshotSection> sections;
+	vector<string> payloads;
+
+	for (size_t length = 1; length < wordsByLength.size(); length++)
+	{
+		if (wordsByLength[length].empty())
+		{
+			continue;
+		}
+
+		WordLadder wordLadder((int)length, GRAPH_ENGINE);
+
+		wordLadder.packedWords.swap(wordsByLength[length]);
+		wordLadder.sortPackedWords();
+		wordLadder.buildIndex();
+		wordLadder.buildBuckets();
+
+		string payload;
+
+		appendBlock(payload, wordLadder.packedWords.data(), wordLadder.packedWords.size());
+		appendBlock(payload, wordLadder.adjacencyOffsets.data(), wordLadder.adjacencyOffsets.size() * sizeof(int));
+		appendBlock(payload, wordLadder.adjacencyTargets.data(), wordLadder.adjacencyTargets.size() * sizeof(int));
+		appendBlock(payload, wordLadder.bucketOffsets.data(), wordLadder.bucketOffsets.size() * sizeof(int));
+		appendBlock(payload, wordLadder.bucketWords.data(), wordLadder.bucketWords.size() * sizeof(int));
+		appendBlock(payload, wordLadder.wordBuckets.data(), wordLadder.wordBuckets.size() * sizeof(int));
+
+		SnapshotSection section;
+
+		section.wordLength = (uint32_t)length;
+		section.wordCount = (uint32_t)wordLadder.wordCount;
+		section.offset = 0; // This is filled in once we know where every section goes.
+		section.size = payload.size();
+		section.checksum = getChecksum(payload.data(), payload.size());
+
+		sections.push_back(section);
+		payloads.push_back(payload);
+	}
+
+	SnapshotHeader header;
+
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.byteOrder = SNAPSHOT_BYTE_ORDER;
+	header.version = SNAPSHOT_VERSION;
+	header.sourceSize = (uint64_t)lexiconSize;
+	header.sourceChecksum = lexiconChecksum;
+	header.sectionCount = (uint32_t)sections.size();
+	header.reserved = 0;
+
+	// The payloads follow the section table, one after another.
+	uint64_t offset = sizeof(header) + sections.size() * sizeof(SnapshotSection);
+
+	for (SnapshotSection& section : sections)
+	{
+		section.offset = offset;
+		offset += section.size;
+	}
+
+	ofstream snapshotFile(getSnapshotFileName(lexiconFileName), ios::binary | ios::trunc);
+
+	if (snapshotFile.fail())
+	{
+		cout << "Unable to create snapshot file.\n";
+
+		return -1;
+	}
+
+	snapshotFile.write((const char*)&header, sizeof(header));
+
+	if (!sections.empty())
+	{
+		snapshotFile.write((const char*)sections.data(), sections.size() * sizeof(SnapshotSection));
+	}
+
+	for (const string& payload : payloads)
+	{
+		snapshotFile.write(payload.data(), payload.size());
+	}
+
+	snapshotFile.close();
+
+	if (snapshotFile.fail())
+	{
+		cout << "Unable to write snapshot file.\n";
+
+		return -1;
+	}
+
+	return (int)sections.size();
+}
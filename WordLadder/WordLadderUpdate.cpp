@@ -0,0 +1,679 @@
+//==============================================================================================
+// File: WordLadderUpdate.cpp - Adding and removing words without rebuilding
+// c.f.: WordLadder.h
+//
+// This file implements WordLadder::addWord and WordLadder::removeWord,
+// which patch a loaded lexicon in place. Building the neighbor index
+// looks up the neighbors of every word, which is what makes it slow;
+// a change only needs the neighbors of the one word being added or
+// removed. Everything else in the index just moves along to make room,
+// or to close the gap, and has its word IDs shifted by one.
+//
+// Components are patched the same way: a new word joins the components
+// of all of its neighbors into one, and a removed word can only split
+// its own component, so only that component is searched again.
+//
+// Author:     Nicholas Nassar, University of Toledo
+// Copyright:  Copyright 2020 by Nicholas Nassar. All rights reserved.
+
+#include "WordLadder.h"
+#include "HammingKernel.h"
+#include "PackedWords.h"
+#include <algorithm>
+#include <cstring>
+
+bool WordLadder::addWord(const string& word)
+{
+	// This method finds where the word goes in sorted order,
+	// which becomes its ID, and its neighbors among the words
+	// already there. Then every part of the lexicon gets the
+	// word inserted at that ID.
+	//
+	if (word.length() != (size_t)wordLength)
+	{
+		return false;
+	}
+
+	for (char c : word)
+	{
+		if (isWhitespace(c)) // A lexicon file could never have held this word.
+		{
+			return false;
+		}
+	}
+
+	// We binary search for the first word that doesn't come
+	// before the new one, which is where the new one goes.
+	int low = 0;
+	int high = wordCount;
+
+	while (low < high)
+	{
+		int middle = low + (high - low) / 2;
+
+		if (memcmp(getWordData(middle), word.data(), wordLength) < 0)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	int id = low;
+
+	if (id < wordCount && memcmp(getWordData(id), word.data(), wordLength) == 0) // It's already a word.
+	{
+		return false;
+	}
+
+	// A word that won't pack into a code means the whole lexicon
+	// has to go back to comparing characters.
+	PackedCode code = 0;
+
+	if (packedEngine != nullptr && !packedEngine->encode(word.data(), code))
+	{
+		wordCodes.clear();
+		wordCodes.shrink_to_fit();
+		packedEngine = nullptr;
+	}
+
+	// The neighbors are found before the word is inserted, so
+	// their IDs from the new word's on have to move up by one.
+	vector<int> neighbors;
+
+	scanForNeighbors(word.data(), neighbors);
+
+	for (int& neighbor : neighbors)
+	{
+		if (neighbor >= id)
+		{
+			neighbor++;
+		}
+	}
+
+	packedWords.insert((size_t)id * wordLength, word);
+
+	if (packedEngine != nullptr)
+	{
+		wordCodes.insert(wordCodes.begin() + id, code);
+	}
+
+	wordCount++;
+
+	if (engine == GRAPH_ENGINE)
+	{
+		insertIntoGraph(id, neighbors);
+	}
+	else if (engine == BUCKET_ENGINE)
+	{
+		insertIntoBuckets(id, neighbors);
+	}
+
+	// The new word is in the same component as every one of its
+	// neighbors, so their components all become one, under the
+	// label of the first. A word with no neighbors gets a new one.
+	int labelCount = componentSizes.size() + 1;
+	int label = neighbors.empty() ? labelCount - 1 : wordComponents[neighbors[0] - (neighbors[0] > id)];
+
+	vector<bool> merged(labelCount, false);
+
+	for (int neighbor : neighbors)
+	{
+		merged[wordComponents[neighbor - (neighbor > id)]] = true;
+	}
+
+	wordComponents.insert(wordComponents.begin() + id, label);
+
+	for (int& component : wordComponents)
+	{
+		if (merged[component])
+		{
+			component = label;
+		}
+	}
+
+	// Even without a merge, the new word may now be the smallest in
+	// its component, which can change the order they are numbered in.
+	renumberComponents(labelCount);
+
+	generation++;
+
+	return true;
+}
+
+bool WordLadder::removeWord(const string& word)
+{
+	// This method takes the word out of every part of the lexicon,
+	// closing up the gap it leaves, then checks whether its
+	// component fell apart without it.
+	//
+	int id = getWordId(word);
+
+	if (id == -1)
+	{
+		return false;
+	}
+
+	vector<int> neighbors;
+
+	getNeighbors(id, neighbors);
+
+	int component = wordComponents[id];
+
+	if (engine == GRAPH_ENGINE)
+	{
+		removeFromGraph(id);
+	}
+	else if (engine == BUCKET_ENGINE)
+	{
+		removeFromBuckets(id);
+	}
+
+	packedWords.erase((size_t)id * wordLength, wordLength);
+
+	if (packedEngine != nullptr)
+	{
+		wordCodes.erase(wordCodes.begin() + id);
+	}
+
+	wordCount--;
+	wordComponents.erase(wordComponents.begin() + id);
+
+	for (int& neighbor : neighbors)
+	{
+		if (neighbor > id)
+		{
+			neighbor--;
+		}
+	}
+
+	int labelCount = componentSizes.size();
+
+	// A word with at most one neighbor was on no path between two
+	// other words, so its component is still in one piece.
+	if (neighbors.size() > 1)
+	{
+		if (engine == SCAN_ENGINE)
+		{
+			// Searching the component would scan the lexicon once for
+			// every word in it, which costs more than labelling every
+			// component again, and that needs no index.
+			buildComponents();
+
+			generation++;
+
+			return true;
+		}
+
+		// We search from the first neighbor until every other
+		// neighbor has turned up, in which case nothing split. The
+		// search only stops short of that by running out of words,
+		// and then each neighbor it missed is in a piece of its own,
+		// which we search in full, giving it a new label.
+		vector<int> queue;
+		vector<bool> reached(wordCount, false);
+		vector<bool> isNeighbor(wordCount, false);
+		int neighborsLeft = neighbors.size(); // The neighbors not reached yet
+
+		for (int neighbor : neighbors)
+		{
+			isNeighbor[neighbor] = true;
+		}
+
+		for (unsigned int i = 0; i < neighbors.size(); i++)
+		{
+			if (reached[neighbors[i]])
+			{
+				continue;
+			}
+
+			int label = i == 0 ? component : labelCount++; // The first piece keeps the old label.
+
+			queue.assign(1, neighbors[i]);
+			reached[neighbors[i]] = true;
+			neighborsLeft--;
+
+			for (unsigned int front = 0; front < queue.size() && (i > 0 || neighborsLeft > 0); front++)
+			{
+				wordComponents[queue[front]] = label;
+
+				forEachNeighbor(queue[front], [&](int next)
+				{
+					if (!reached[next])
+					{
+						reached[next] = true;
+						queue.push_back(next);
+						neighborsLeft -= isNeighbor[next];
+					}
+				});
+			}
+
+			if (neighborsLeft == 0) // Every neighbor is still connected to the first.
+			{
+				break;
+			}
+		}
+	}
+
+	renumberComponents(labelCount);
+
+	generation++;
+
+	return true;
+}
+
+unsigned long long WordLadder::getGeneration() const
+{
+	return generation;
+}
+
+void WordLadder::scanForNeighbors(const char* word, vector<int>& neighbors) const
+{
+	// This method compares the word with every word in the
+	// lexicon, a chunk at a time, just like the scan engine's
+	// neighbor lookup, but for a word that has no ID yet.
+	//
+	neighbors.clear();
+
+	PackedCode code = 0;
+
+	if (packedEngine != nullptr)
+	{
+		packedEngine->encode(word, code);
+	}
+
+	int matches[SCAN_CHUNK_SIZE];
+
+	for (int first = 0; first < wordCount; first += SCAN_CHUNK_SIZE)
+	{
+		int count = wordCount - first < SCAN_CHUNK_SIZE ? wordCount - first : SCAN_CHUNK_SIZE;
+		int matchCount = packedEngine != nullptr ?
+			packedEngine->findDistanceOneCodes(wordCodes.data() + first, count, code, matches) :
+			findDistanceOneWords(getWordData(first), count, wordLength, word, matches);
+
+		for (int i = 0; i < matchCount; i++)
+		{
+			neighbors.push_back(first + matches[i]);
+		}
+	}
+}
+
+void WordLadder::insertIntoGraph(int id, const vector<int>& neighbors)
+{
+	// This method patches the graph where it lies. The rows grow
+	// by two edges for each neighbor: the new word's row holds
+	// them all, and each neighbor gets the new word added to the
+	// end of its own row. Between two of those places, every row
+	// moves the same distance toward the end, so each stretch of
+	// rows is moved with a single copy, from the last stretch back
+	// to the first, which never writes over an edge not yet moved.
+	//
+	int neighborCount = neighbors.size();
+
+	// The edges are renumbered first, while they are still in one
+	// piece: every ID from the new word's on moves up by one. It is
+	// written without a branch, which would be taken half the time
+	// at random, and which keeps the compiler from vectorizing it.
+	for (int& target : adjacencyTargets)
+	{
+		target += target >= id;
+	}
+
+	int oldEnd = adjacencyTargets.size();	// Where the stretch we move next ends, before the move
+	int edge = oldEnd + neighborCount * 2;	// Where it ends, after the move
+
+	adjacencyTargets.resize(edge);
+
+	int nextNeighbor = neighborCount - 1; // The neighbors are in increasing order, just like the rows.
+	bool rowPlaced = false;
+
+	while (nextNeighbor >= 0 || !rowPlaced)
+	{
+		// The old rows from the new word's ID on all start after the
+		// new row, and the rows after a neighbor's start after the
+		// edge added to it, whichever of the two comes later.
+		bool isRow = !rowPlaced && (nextNeighbor < 0 || neighbors[nextNeighbor] < id);
+		int row = isRow ? id : neighbors[nextNeighbor];
+		int stretchStart = isRow ? adjacencyOffsets[id] : adjacencyOffsets[(row < id ? row : row - 1) + 1];
+
+		copy_backward(adjacencyTargets.begin() + stretchStart, adjacencyTargets.begin() + oldEnd, adjacencyTargets.begin() + edge);
+		edge -= oldEnd - stretchStart;
+		oldEnd = stretchStart;
+
+		if (isRow)
+		{
+			edge -= neighborCount;
+			copy(neighbors.begin(), neighbors.end(), adjacencyTargets.begin() + edge);
+			rowPlaced = true;
+		}
+		else
+		{
+			adjacencyTargets[--edge] = id;
+			nextNeighbor--;
+		}
+	}
+
+	// Every row starts where its old row did, plus the edges added
+	// before it. Going from the last row back, each one's offset
+	// comes from the offset before it, which is yet to be written.
+	int added = neighborCount * 2; // The edges added before the row, and in it
+
+	adjacencyOffsets.push_back(adjacencyTargets.size());
+	nextNeighbor = neighborCount - 1;
+
+	for (int row = wordCount - 1; row >= 0; row--)
+	{
+		if (row == id)
+		{
+			added -= neighborCount;
+		}
+		else if (nextNeighbor >= 0 && neighbors[nextNeighbor] == row)
+		{
+			added--;
+			nextNeighbor--;
+		}
+
+		adjacencyOffsets[row] = adjacencyOffsets[row <= id ? row : row - 1] + added;
+	}
+}
+
+void WordLadder::removeFromGraph(int id)
+{
+	// This method patches the graph where it lies, leaving out the
+	// removed word's row and every edge to it, and shifting the IDs
+	// after it down. Everything only ever moves toward the front,
+	// so a single pass over the edges closes up every gap, and a
+	// single pass over the rows moves their offsets to match.
+	//
+	int rowStart = adjacencyOffsets[id];
+	int rowEnd = adjacencyOffsets[id + 1];
+	int edgeCount = adjacencyTargets.size();
+	int edge = 0;
+
+	// The word's neighbors are the rows that each lose an edge.
+	vector<int> neighbors(adjacencyTargets.begin() + rowStart, adjacencyTargets.begin() + rowEnd);
+
+	sort(neighbors.begin(), neighbors.end());
+
+	for (int oldEdge = 0; oldEdge < edgeCount; oldEdge++)
+	{
+		int target = adjacencyTargets[oldEdge];
+
+		if (target != id && (oldEdge < rowStart || oldEdge >= rowEnd))
+		{
+			adjacencyTargets[edge++] = target - (target > id); // Without a branch, as in insertIntoGraph
+		}
+	}
+
+	adjacencyTargets.resize(edge);
+
+	int removed = 0; // The edges removed before the row
+	unsigned int nextNeighbor = 0;
+
+	for (int row = 0; row < wordCount; row++)
+	{
+		if (row == id)
+		{
+			removed += rowEnd - rowStart;
+
+			continue;
+		}
+
+		adjacencyOffsets[row < id ? row : row - 1] = adjacencyOffsets[row] - removed;
+
+		if (nextNeighbor < neighbors.size() && neighbors[nextNeighbor] == row)
+		{
+			removed++;
+			nextNeighbor++;
+		}
+	}
+
+	adjacencyOffsets[wordCount - 1] = edge;
+	adjacencyOffsets.pop_back();
+}
+
+void WordLadder::insertIntoBuckets(int id, const vector<int>& neighbors)
+{
+	// This method works out which bucket the new word belongs in
+	// for each position. A neighbor differs from it in just one
+	// position, so it shares the new word's pattern for that one.
+	// If the neighbor already has a bucket for it, the new word
+	// joins that bucket; otherwise, the two of them start a new one.
+	//
+	vector<int> joinedBuckets(wordLength, -1);	// The existing bucket the new word joins, by position
+	vector<int> partners(wordLength, -1);		// The word it starts a new bucket with, by position
+
+	for (int neighbor : neighbors)
+	{
+		const char* first = getWordData(id);
+		const char* second = getWordData(neighbor);
+		int position = 0;
+
+		while (first[position] == second[position])
+		{
+			position++;
+		}
+
+		int bucket = wordBuckets[(neighbor > id ? neighbor - 1 : neighbor) * wordLength + position];
+
+		if (bucket != -1)
+		{
+			joinedBuckets[position] = bucket;
+		}
+		else
+		{
+			partners[position] = neighbor; // Without a bucket, this neighbor must be the only one.
+		}
+	}
+
+	// The new word's buckets go in at its ID, and every member
+	// from its ID on moves up by one, just as the edges do in
+	// insertIntoGraph.
+	wordBuckets.insert(wordBuckets.begin() + (size_t)id * wordLength, wordLength, -1);
+
+	for (int& member : bucketWords)
+	{
+		member += member >= id;
+	}
+
+	// The buckets the new word joins grow by one member at the
+	// end, so, again as in insertIntoGraph, the stretches between
+	// them are each moved with a single copy, from the last back.
+	vector<pair<int, int>> joined; // The buckets the new word joins, with their positions
+
+	for (int position = 0; position < wordLength; position++)
+	{
+		if (joinedBuckets[position] != -1)
+		{
+			joined.push_back(make_pair(joinedBuckets[position], position));
+		}
+	}
+
+	sort(joined.begin(), joined.end());
+
+	int bucketCount = bucketOffsets.size() - 1;
+	int oldEnd = bucketWords.size();			// Where the stretch we move next ends, before the move
+	int member = oldEnd + (int)joined.size();	// Where it ends, after the move
+
+	bucketWords.resize(member);
+
+	for (int i = (int)joined.size() - 1; i >= 0; i--)
+	{
+		int bucket = joined[i].first;
+		int stretchStart = bucketOffsets[bucket + 1];
+
+		copy_backward(bucketWords.begin() + stretchStart, bucketWords.begin() + oldEnd, bucketWords.begin() + member);
+		member -= oldEnd - stretchStart;
+		oldEnd = stretchStart;
+
+		bucketWords[--member] = id;
+		wordBuckets[id * wordLength + joined[i].second] = bucket;
+	}
+
+	// Every bucket starts where it did, plus the members added to
+	// the buckets before it.
+	int added = joined.size(); // The members added before the bucket, and in it
+	int nextJoined = (int)joined.size() - 1;
+
+	for (int bucket = bucketCount - 1; bucket >= 0 && added > 0; bucket--)
+	{
+		if (nextJoined >= 0 && joined[nextJoined].first == bucket)
+		{
+			added--;
+			nextJoined--;
+		}
+
+		bucketOffsets[bucket] += added;
+	}
+
+	// The new buckets go on the end, their members in order of ID.
+	bucketOffsets.pop_back();
+
+	for (int position = 0; position < wordLength; position++)
+	{
+		if (joinedBuckets[position] == -1 && partners[position] != -1)
+		{
+			int bucket = bucketOffsets.size();
+
+			bucketOffsets.push_back(bucketWords.size());
+			bucketWords.push_back(partners[position] < id ? partners[position] : id);
+			bucketWords.push_back(partners[position] < id ? id : partners[position]);
+
+			wordBuckets[partners[position] * wordLength + position] = bucket;
+			wordBuckets[id * wordLength + position] = bucket;
+		}
+	}
+
+	bucketOffsets.push_back(bucketWords.size());
+}
+
+void WordLadder::removeFromBuckets(int id)
+{
+	// This method takes the removed word out of each of its
+	// buckets. A bucket left with a single word would give that
+	// word no neighbors, so it goes too, just as buildBuckets
+	// never makes one, and the buckets after it are renumbered.
+	// Everything only ever moves toward the front, so, just as in
+	// removeFromGraph, a single pass over the members closes up
+	// every gap, and a single pass over the buckets moves their
+	// offsets to match.
+	//
+	vector<int> ownBuckets;			// The buckets the word is in, in order
+	vector<int> droppedBuckets;		// The ones that go, in order
+
+	for (int position = 0; position < wordLength; position++)
+	{
+		int bucket = wordBuckets[id * wordLength + position];
+
+		if (bucket == -1)
+		{
+			continue;
+		}
+
+		ownBuckets.push_back(bucket);
+
+		if (bucketOffsets[bucket + 1] - bucketOffsets[bucket] == 2)
+		{
+			int other = bucketWords[bucketOffsets[bucket]] == id ? bucketWords[bucketOffsets[bucket] + 1] : bucketWords[bucketOffsets[bucket]];
+
+			wordBuckets[other * wordLength + position] = -1;
+			droppedBuckets.push_back(bucket);
+		}
+	}
+
+	sort(ownBuckets.begin(), ownBuckets.end());
+	sort(droppedBuckets.begin(), droppedBuckets.end());
+
+	// The members are copied down a stretch at a time, skipping
+	// over the buckets that go.
+	int memberCount = bucketWords.size();
+	int member = 0;
+	int oldMember = 0;
+
+	for (unsigned int i = 0; i <= droppedBuckets.size(); i++)
+	{
+		int stretchEnd = i < droppedBuckets.size() ? bucketOffsets[droppedBuckets[i]] : memberCount;
+
+		for (; oldMember < stretchEnd; oldMember++)
+		{
+			int word = bucketWords[oldMember];
+
+			if (word != id)
+			{
+				bucketWords[member++] = word - (word > id); // Without a branch, as in insertIntoGraph
+			}
+		}
+
+		if (i < droppedBuckets.size())
+		{
+			oldMember = bucketOffsets[droppedBuckets[i] + 1];
+		}
+	}
+
+	bucketWords.resize(member);
+
+	int bucketCount = bucketOffsets.size() - 1;
+	int removed = 0;		// The members removed before the bucket
+	int droppedCount = 0;	// The buckets dropped before it
+	unsigned int nextBucket = 0;
+
+	for (int bucket = 0; bucket < bucketCount; bucket++)
+	{
+		bool hasWord = nextBucket < ownBuckets.size() && ownBuckets[nextBucket] == bucket;
+		bool dropped = hasWord && droppedCount < (int)droppedBuckets.size() && droppedBuckets[droppedCount] == bucket;
+
+		nextBucket += hasWord;
+
+		if (dropped)
+		{
+			removed += 2;
+			droppedCount++;
+
+			continue;
+		}
+
+		bucketOffsets[bucket - droppedCount] = bucketOffsets[bucket] - removed;
+		removed += hasWord;
+	}
+
+	bucketOffsets[bucketCount - droppedCount] = member;
+	bucketOffsets.resize(bucketCount - droppedCount + 1);
+
+	wordBuckets.erase(wordBuckets.begin() + (size_t)id * wordLength, wordBuckets.begin() + (size_t)(id + 1) * wordLength);
+
+	// A bucket's new number is its old one, less the number of
+	// buckets that went before it. No word is left in one that
+	// went, and taking the highest first means each comparison
+	// is made with a number that hasn't been lowered past it.
+	for (int i = (int)droppedBuckets.size() - 1; i >= 0; i--)
+	{
+		for (int& bucket : wordBuckets)
+		{
+			bucket -= bucket > droppedBuckets[i];
+		}
+	}
+}
+
+void WordLadder::renumberComponents(int labelCount)
+{
+	// Just as at the end of buildComponents, each label gets the
+	// next number the first time one of its words comes up.
+	//
+	vector<int> numbers(labelCount, -1);
+
+	componentSizes.clear();
+
+	for (int& component : wordComponents)
+	{
+		if (numbers[component] == -1)
+		{
+			numbers[component] = componentSizes.size();
+			componentSizes.push_back(0);
+		}
+
+		component = numbers[component];
+		componentSizes[component]++;
+	}
+}